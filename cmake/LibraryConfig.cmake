@@ -20,6 +20,13 @@ endif()
 # Target
 add_library(${LIBRARY_NAME} ${LIBRARY_TYPE} ${SOURCES} ${HEADERS})
 
+# Calls between the functions of the shared library can then be bound directly and inlined
+include(CheckCXXCompilerFlag)
+check_cxx_compiler_flag(-fno-semantic-interposition HAS_NO_SEMANTIC_INTERPOSITION)
+if(HAS_NO_SEMANTIC_INTERPOSITION)
+  target_compile_options(${LIBRARY_NAME} PRIVATE -fno-semantic-interposition)
+endif()
+
 # Install library
 install(TARGETS ${LIBRARY_NAME}
   EXPORT ${PROJECT_EXPORT}
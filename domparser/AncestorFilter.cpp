@@ -0,0 +1,147 @@
+#include "AncestorFilter.h"
+
+#include <limits>
+
+namespace
+{
+    const uint32_t tagSalt = 0x2C1B3C6Du;
+    const uint32_t idSalt = 0x297A2D39u;
+    const uint32_t classSalt = 0x6B43A9B5u;
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    uint32_t mix(uint32_t value)
+    {
+        value ^= value >> 16;
+        value *= 0x7FEB352Du;
+        value ^= value >> 15;
+        value *= 0x846CA68Bu;
+        value ^= value >> 16;
+        return value;
+    }
+
+    uint32_t hashString(const char* data, size_t size, uint32_t salt)
+    {
+        uint32_t value = 2166136261u ^ salt;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            value ^= static_cast<unsigned char>(data[i]);
+            value *= 16777619u;
+        }
+        return mix(value);
+    }
+}
+
+const uint32_t AncestorFilter::size;
+
+uint32_t AncestorFilter::hashTag(AtomTable::Atom atom)
+{
+    return mix(atom ^ tagSalt);
+}
+
+uint32_t AncestorFilter::hashId(const StringSpan& id)
+{
+    return hashString(id.data(), id.size(), idSalt);
+}
+
+uint32_t AncestorFilter::hashClass(const StringSpan& word)
+{
+    return hashString(word.data(), word.size(), classSalt);
+}
+
+void AncestorFilter::push(const Tag& tag)
+{
+    static const AtomTable::Atom idAtom = AtomTable::getGlobal().intern("id");
+    static const AtomTable::Atom classAtom = AtomTable::getGlobal().intern("class");
+
+    m_Ancestors.push_back({&tag, m_Hashes.size(), m_Complete});
+    add(hashTag(tag.getTagAtom()));
+
+    for (const auto& i : tag.getAttributes())
+    {
+        if (i.atom == idAtom)
+        {
+            add(hashId(i.value));
+        }
+        else if (i.atom == classAtom)
+        {
+            for (size_t j = 0; j < i.value.size();)
+            {
+                if (isSpace(i.value[j]))
+                {
+                    ++j;
+                    continue;
+                }
+                const size_t begin = j;
+
+                while (j < i.value.size() && !isSpace(i.value[j]))
+                {
+                    ++j;
+                }
+                add(hashClass(StringSpan(i.value.data() + begin, j - begin)));
+            }
+        }
+    }
+}
+
+void AncestorFilter::moveTo(const Tag& tag)
+{
+    const Tag* parent = tag.getParent();
+
+    while (!m_Ancestors.empty() && m_Ancestors.back().tag != parent)
+    {
+        pop();
+    }
+    m_Complete = parent == nullptr || (!m_Ancestors.empty() && m_Ancestors.back().complete);
+}
+
+void AncestorFilter::pop()
+{
+    for (size_t i = m_Ancestors.back().firstHash; i < m_Hashes.size(); ++i)
+    {
+        remove(m_Hashes[i]);
+    }
+    m_Hashes.resize(m_Ancestors.back().firstHash);
+    m_Ancestors.pop_back();
+}
+
+void AncestorFilter::clear()
+{
+    m_Counters.fill(0);
+    m_Ancestors.clear();
+    m_Hashes.clear();
+    m_Complete = true;
+}
+
+bool AncestorFilter::mayContain(uint32_t hash) const
+{
+    return !m_Complete || (m_Counters[hash & (size - 1)] != 0 && m_Counters[(hash >> 16) & (size - 1)] != 0);
+}
+
+void AncestorFilter::add(uint32_t hash)
+{
+    m_Hashes.push_back(hash);
+
+    for (const uint32_t slot : {hash & (size - 1), (hash >> 16) & (size - 1)})
+    {
+        if (m_Counters[slot] != std::numeric_limits<uint8_t>::max())
+        {
+            ++m_Counters[slot];
+        }
+    }
+}
+
+void AncestorFilter::remove(uint32_t hash)
+{
+    for (const uint32_t slot : {hash & (size - 1), (hash >> 16) & (size - 1)})
+    {
+        if (m_Counters[slot] != std::numeric_limits<uint8_t>::max())
+        {
+            --m_Counters[slot];
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef DOMPARSER_ANCESTORFILTER_H
+#define DOMPARSER_ANCESTORFILTER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "AtomTable.h"
+#include "StringSpan.h"
+#include "Tag.h"
+
+// Counting Bloom filter of the names, ids and class words of the ancestors
+// of the current tag, kept while the tags of a document are visited in
+// document order. A selector whose ancestor compounds need a key the filter
+// does not contain is rejected without following the parent links. The
+// filter may answer yes for a key it does not hold, never the reverse.
+class AncestorFilter
+{
+public:
+    AncestorFilter() = default;
+    ~AncestorFilter() = default;
+
+    // Drops the tags that are not ancestors of the given one, call before testing it
+    void moveTo(const Tag&);
+    // Adds the tag as the ancestor of the tags that follow, call after testing it
+    void push(const Tag&);
+    void clear();
+
+    bool mayContain(uint32_t) const;
+
+    static uint32_t hashTag(AtomTable::Atom);
+    static uint32_t hashId(const StringSpan&);
+    static uint32_t hashClass(const StringSpan&);
+
+private:
+    static const uint32_t size = 1 << 12;
+
+    struct Ancestor
+    {
+        const Tag* tag;
+        // Where the hashes of its keys start in m_Hashes
+        size_t firstHash;
+        // Whether all the ancestors of the tag are in the filter
+        bool complete;
+    };
+
+    void add(uint32_t);
+    void remove(uint32_t);
+    void pop();
+
+private:
+    // Saturated counters are never decremented, the filter then only loses precision
+    std::array<uint8_t, size> m_Counters {};
+    std::vector<Ancestor> m_Ancestors {};
+    // The hashes are kept so that a tag is not hashed again when it is popped
+    std::vector<uint32_t> m_Hashes {};
+    // A tag whose ancestors were not all visited gets no rejection
+    bool m_Complete = true;
+};
+
+#endif //DOMPARSER_ANCESTORFILTER_H
@@ -0,0 +1,93 @@
+#include "Arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+Arena::Arena(size_t blockSize)
+: m_BlockSize(blockSize)
+{
+
+}
+
+Arena::~Arena()
+{
+    for (const auto& i : m_Blocks)
+    {
+        ::operator delete(i.data);
+    }
+}
+
+char* Arena::allocateFrom(size_t block, size_t size, size_t alignment)
+{
+    const Block& current = m_Blocks[block];
+    const size_t offset = block == m_CurrentBlock ? m_Offset : 0;
+    const uintptr_t address = reinterpret_cast<uintptr_t>(current.data) + offset;
+    const size_t padding = (alignment - address % alignment) % alignment;
+
+    if (offset + padding + size > current.size)
+    {
+        return nullptr;
+    }
+    m_CurrentBlock = block;
+    m_Offset = offset + padding + size;
+    m_Used += padding + size;
+    return current.data + offset + padding;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    // Blocks kept by reset() are reused in order before a new one is requested
+    for (size_t i = m_CurrentBlock; i < m_Blocks.size(); ++i)
+    {
+        char* result = allocateFrom(i, size, alignment);
+        if (result != nullptr)
+        {
+            return result;
+        }
+    }
+
+    const size_t blockSize = size + alignment > m_BlockSize ? size + alignment : m_BlockSize;
+    m_Blocks.push_back({static_cast<char*>(::operator new(blockSize)), blockSize});
+    return allocateFrom(m_Blocks.size() - 1, size, alignment);
+}
+
+StringSpan Arena::copy(const StringSpan& str)
+{
+    if (str.empty())
+    {
+        return StringSpan();
+    }
+    char* data = static_cast<char*>(allocate(str.size(), 1));
+    std::memcpy(data, str.data(), str.size());
+    return StringSpan(data, str.size());
+}
+
+void Arena::adopt(char* data, size_t size, size_t used)
+{
+    // Blocks before the current one are full until reset()
+    m_Blocks.insert(m_Blocks.begin() + static_cast<std::ptrdiff_t>(m_CurrentBlock), {data, size});
+    ++m_CurrentBlock;
+    m_Used += used;
+}
+
+void Arena::reset()
+{
+    m_CurrentBlock = 0;
+    m_Offset = 0;
+    m_Used = 0;
+}
+
+size_t Arena::getUsed() const
+{
+    return m_Used;
+}
+
+size_t Arena::getCapacity() const
+{
+    size_t result = 0;
+    for (const auto& i : m_Blocks)
+    {
+        result += i.size;
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef DOMPARSER_ARENA_H
+#define DOMPARSER_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "StringSpan.h"
+
+// Bump allocator owning the nodes, attributes and copied strings of one
+// document. Nothing is freed individually: reset() makes all blocks
+// available again for the next document and the destructor releases them.
+class Arena
+{
+public:
+    explicit Arena(size_t = 64 * 1024); // Block size
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t, size_t = alignof(std::max_align_t));
+    StringSpan copy(const StringSpan&);
+    // Takes over a block allocated with ::operator new, whose first bytes are in use. Its
+    // size is reused after reset() like that of the other blocks.
+    void adopt(char*, size_t, size_t);
+    // The objects allocated so far must be destroyed before
+    void reset();
+    size_t getUsed() const;
+    size_t getCapacity() const;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+private:
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+
+    char* allocateFrom(size_t, size_t, size_t);
+
+private:
+    std::vector<Block> m_Blocks {};
+    size_t m_BlockSize;
+    size_t m_CurrentBlock = 0;
+    size_t m_Offset = 0;
+    size_t m_Used = 0;
+};
+
+#endif //DOMPARSER_ARENA_H
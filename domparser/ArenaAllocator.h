@@ -0,0 +1,72 @@
+#ifndef DOMPARSER_ARENAALLOCATOR_H
+#define DOMPARSER_ARENAALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+#include "Arena.h"
+
+// Standard allocator over an Arena. Without an arena it falls back to the
+// global heap, so tags created outside of a document work as before.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(Arena* arena = nullptr) noexcept
+    : m_Arena(arena)
+    {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+    : m_Arena(other.getArena())
+    {}
+
+    T* allocate(size_t size)
+    {
+        if (m_Arena != nullptr)
+        {
+            return static_cast<T*>(m_Arena->allocate(size * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(size * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept
+    {
+        // Arena memory is released together with the whole document
+        if (m_Arena == nullptr)
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    Arena* getArena() const noexcept
+    {
+        return m_Arena;
+    }
+
+    // A copied container, such as the attributes of a tag copied out of a document, must not
+    // live in the arena: the arena is reused for the next document while the copy is alive
+    ArenaAllocator select_on_container_copy_construction() const noexcept
+    {
+        return ArenaAllocator();
+    }
+
+private:
+    Arena* m_Arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right) noexcept
+{
+    return left.getArena() == right.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right) noexcept
+{
+    return left.getArena() != right.getArena();
+}
+
+#endif //DOMPARSER_ARENAALLOCATOR_H
@@ -0,0 +1,119 @@
+#include "AtomTable.h"
+
+const AtomTable::Atom AtomTable::None;
+
+AtomTable::AtomTable()
+: m_Names(1),
+  m_Slots(256, None)
+{
+    // Known names keep their enum values as atoms and never reach the hash below
+    for (size_t i = 1; i <= KnownNames::getCount(); ++i)
+    {
+        m_Names.emplace_back(KnownNames::getName(static_cast<KnownName>(i)));
+    }
+}
+
+AtomTable& AtomTable::getGlobal()
+{
+    static AtomTable table;
+    return table;
+}
+
+size_t AtomTable::hash(const StringSpan& name)
+{
+    // FNV-1a, names are short
+    size_t result = 2166136261u;
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        result = (result ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return result;
+}
+
+size_t AtomTable::findSlot(const StringSpan& name, size_t hashValue) const
+{
+    const size_t mask = m_Slots.size() - 1;
+    size_t slot = hashValue & mask;
+
+    while (m_Slots[slot] != None && m_Names[m_Slots[slot]] != name)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void AtomTable::grow()
+{
+    std::vector<Atom> slots(m_Slots.size() * 2, None);
+    m_Slots.swap(slots);
+
+    for (const auto& i : slots)
+    {
+        if (i != None)
+        {
+            m_Slots[findSlot(m_Names[i], hash(m_Names[i]))] = i;
+        }
+    }
+}
+
+AtomTable::Atom AtomTable::intern(const StringSpan& name)
+{
+    const KnownName known = KnownNames::find(name);
+    if (known != KnownName::None || name.empty())
+    {
+        return static_cast<Atom>(known);
+    }
+    const size_t hashValue = hash(name);
+    std::lock_guard<std::shared_timed_mutex> lock(m_Mutex);
+
+    size_t slot = findSlot(name, hashValue);
+    if (m_Slots[slot] != None)
+    {
+        return m_Slots[slot];
+    }
+
+    // Keep the load factor under one half
+    if (m_Names.size() * 2 >= m_Slots.size())
+    {
+        grow();
+        slot = findSlot(name, hashValue);
+    }
+    const Atom atom = static_cast<Atom>(m_Names.size());
+    m_Names.emplace_back(m_Characters.copy(name));
+    m_Slots[slot] = atom;
+    m_Generation.fetch_add(1, std::memory_order_release);
+    return atom;
+}
+
+AtomTable::Atom AtomTable::find(const StringSpan& name) const
+{
+    const KnownName known = KnownNames::find(name);
+    if (known != KnownName::None || name.empty())
+    {
+        return static_cast<Atom>(known);
+    }
+    if (getGeneration() == 0)
+    {
+        // Nothing but the known names, no need to lock
+        return None;
+    }
+    const size_t hashValue = hash(name);
+    std::shared_lock<std::shared_timed_mutex> lock(m_Mutex);
+    return m_Slots[findSlot(name, hashValue)];
+}
+
+StringSpan AtomTable::getName(Atom atom) const
+{
+    if (atom <= KnownNames::getCount())
+    {
+        return KnownNames::getName(static_cast<KnownName>(atom));
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(m_Mutex);
+    return atom < m_Names.size() ? m_Names[atom] : StringSpan();
+}
+
+size_t AtomTable::getSize() const
+{
+    std::shared_lock<std::shared_timed_mutex> lock(m_Mutex);
+    return m_Names.size() - 1;
+}
@@ -0,0 +1,68 @@
+#ifndef DOMPARSER_ATOMTABLE_H
+#define DOMPARSER_ATOMTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+#include "Arena.h"
+#include "KnownNames.h"
+#include "StringSpan.h"
+
+// Maps tag and attribute names to small integer ids, so that names are
+// compared as integers. Known HTML names are resolved by their perfect hash,
+// other names are interned on first use. Atoms are never removed: an id stays valid for the
+// life of the table, and rules compiled once can be reused across documents.
+// Rules intern their names, documents only look theirs up, so the table does
+// not grow with the pages that are parsed.
+// The table is safe to use from several threads.
+class AtomTable
+{
+public:
+    using Atom = uint32_t;
+    static const Atom None = 0; // Empty or unknown name
+
+    AtomTable();
+    ~AtomTable() = default;
+
+    AtomTable(const AtomTable&) = delete;
+    AtomTable& operator=(const AtomTable&) = delete;
+
+    // Table shared by all documents and rules of the process
+    static AtomTable& getGlobal();
+
+    Atom intern(const StringSpan&);
+    // Does not add the name, returns None if it has not been interned
+    Atom find(const StringSpan&) const;
+    StringSpan getName(Atom) const;
+    size_t getSize() const;
+    // Changes whenever a name is added, a name that find() missed may be found after a change
+    uint32_t getGeneration() const;
+    static bool isKnown(Atom);
+
+private:
+    static size_t hash(const StringSpan&);
+    size_t findSlot(const StringSpan&, size_t) const;
+    void grow();
+
+private:
+    mutable std::shared_timed_mutex m_Mutex {};
+    std::atomic<uint32_t> m_Generation {0};
+    Arena m_Characters {};
+    std::vector<StringSpan> m_Names {};
+    std::vector<Atom> m_Slots {}; // Open addressing, None marks a free slot
+};
+
+inline uint32_t AtomTable::getGeneration() const
+{
+    return m_Generation.load(std::memory_order_acquire);
+}
+
+inline bool AtomTable::isKnown(Atom atom)
+{
+    return atom != None && atom <= KnownNames::getCount();
+}
+
+#endif //DOMPARSER_ATOMTABLE_H
@@ -0,0 +1,111 @@
+#ifndef DOMPARSER_CHECKRULES_H
+#define DOMPARSER_CHECKRULES_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "AncestorFilter.h"
+#include "CheckRulesFactory.h"
+#include "Document.h"
+
+// Loop of a traversal of the whole document, check is called with the tag and the filter
+template <typename Check>
+void selectDocumentNodes(Document& document, bool filtered, std::vector<uint32_t>& result, size_t limit, Check check)
+{
+    NodeTable& nodes = document.getNodes();
+    AncestorFilter filter;
+
+    for (uint32_t i = 0; i < nodes.size() && result.size() < limit; ++i)
+    {
+        Tag& tag = nodes[i];
+        if (tag.isRemoved())
+        {
+            continue;
+        }
+
+        if (filtered)
+        {
+            filter.moveTo(tag);
+        }
+
+        if (check(&tag, filter))
+        {
+            result.push_back(i);
+        }
+
+        if (filtered)
+        {
+            filter.push(tag);
+        }
+    }
+}
+
+// Loop over the candidates a document index found for the rule
+template <typename Check>
+void selectCandidateNodes(Document& document, const std::vector<uint32_t>& candidates, std::vector<uint32_t>& result,
+                          size_t limit, Check check)
+{
+    NodeTable& nodes = document.getNodes();
+
+    for (size_t i = 0; i < candidates.size() && result.size() < limit; ++i)
+    {
+        if (check(&nodes[candidates[i]]))
+        {
+            result.push_back(candidates[i]);
+        }
+    }
+}
+
+// Base of the rules. The traversals are instantiated for the rule itself and call its
+// checkRules without virtual dispatch, so it can be inlined into the loop. Rules that
+// use the ancestor filter set Filtered and define checkRules(Tag*, const AncestorFilter&).
+// A rule instantiates its base in its own translation unit, next to its checkRules.
+template <typename Rule, bool Filtered = false>
+class CheckRules : public CheckRulesFactory
+{
+public:
+    virtual void selectNodes(Document& document, std::vector<uint32_t>& result, size_t limit) const
+    {
+        selectHelper(document, result, limit, std::integral_constant<bool, Filtered>());
+    }
+
+    virtual void selectNodes(Document& document, const std::vector<uint32_t>& candidates, std::vector<uint32_t>& result,
+                             size_t limit) const
+    {
+        const Rule& rule = static_cast<const Rule&>(*this);
+        selectCandidateNodes(document, candidates, result, limit, [&rule](Tag* tag)
+        {
+            return rule.Rule::checkRules(tag);
+        });
+    }
+
+private:
+    void selectHelper(Document& document, std::vector<uint32_t>& result, size_t limit, std::false_type) const
+    {
+        const Rule& rule = static_cast<const Rule&>(*this);
+        selectDocumentNodes(document, false, result, limit, [&rule](Tag* tag, const AncestorFilter&)
+        {
+            return rule.Rule::checkRules(tag);
+        });
+    }
+
+    // A template, so that it is only instantiated for the rules that have the filtered checkRules
+    template <typename FilteredRule = Rule>
+    void selectHelper(Document& document, std::vector<uint32_t>& result, size_t limit, std::true_type) const
+    {
+        const FilteredRule& rule = static_cast<const FilteredRule&>(*this);
+
+        if (!rule.FilteredRule::usesAncestorFilter())
+        {
+            selectHelper(document, result, limit, std::false_type());
+            return;
+        }
+        selectDocumentNodes(document, true, result, limit, [&rule](Tag* tag, const AncestorFilter& filter)
+        {
+            return rule.FilteredRule::checkRules(tag, filter);
+        });
+    }
+};
+
+#endif //DOMPARSER_CHECKRULES_H
@@ -1,10 +1,13 @@
 #ifndef DOMPARSER_CHECKRULESFACTORY_H
 #define DOMPARSER_CHECKRULESFACTORY_H
 
+#include "AncestorFilter.h"
 #include "Tag.h"
+#include <cstdint>
 #include <vector>
 #include <string>
-#include <regex>
+
+class Document;
 
 class CheckRulesFactory
 {
@@ -12,6 +15,34 @@ public:
     CheckRulesFactory() = default;
     virtual ~CheckRulesFactory() = default;
     virtual bool checkRules(Tag*) const = 0;
+    // Same result, for tags visited in document order with the filter kept on their ancestors
+    virtual bool checkRules(Tag*, const AncestorFilter&) const;
+    // Whether the filter lets the rule reject tags, a traversal only keeps one then
+    virtual bool usesAncestorFilter() const;
+    // Whether a tag can only be checked once what follows its start tag is parsed (":empty",
+    // ":last-child"). Otherwise the tag, its ancestors and the tags before it are enough.
+    virtual bool needsFollowingContent() const;
+    // Whether the rule reads the siblings or the content of a tag (":nth-child", "A + B", ":empty"),
+    // which a streaming parser does not keep
+    virtual bool needsDocument() const;
+    // Whether every matching tag lies in the subtree of a tag isRegionRoot() accepts, including the
+    // tag itself. Only the name and the attributes of a tag are read to tell, so a builder can leave
+    // out the tags outside of such subtrees.
+    virtual bool hasRegions() const;
+    virtual bool isRegionRoot(const Tag&) const;
+    // Name, or attribute, that every matching tag has. AtomTable::None when there is
+    // none, otherwise a set of rules can skip the rule for the other tags.
+    virtual AtomTable::Atom getTagAtom() const;
+    virtual AtomTable::Atom getAttributeAtom() const;
+    // The id, or one of the class words, every matching tag has when the attribute is "id"
+    // or "class". nullptr if there is none.
+    virtual const std::string* getKeyValue() const;
+    // Appends the indices of the matching tags of the document, or of the candidates, in document
+    // order while the result holds fewer than limit. Removed tags are skipped. Rules derived from
+    // CheckRules override these with loops that call their checkRules directly.
+    virtual void selectNodes(Document&, std::vector<uint32_t>&, size_t) const;
+    virtual void selectNodes(Document&, const std::vector<uint32_t>&, std::vector<uint32_t>&, size_t) const;
+    // Compiles the rule, nullptr if it is incorrect. SelectorCache shares compiled rules.
     static CheckRulesFactory* createCheckRulesFactory(const std::string&);
 };
 
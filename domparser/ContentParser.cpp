@@ -1,9 +1,23 @@
 #include "ContentParser.h"
-#include <iostream>
+
+#include <cctype>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+
+    // [\w.-], the first character of a name is [a-zA-Z_]
+    bool isNameCharacter(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '.' || c == '-';
+    }
+}
 
 ContentParser::ContentParser(const std::string& data)
-: BaseParser(data),
-  m_RegexValue("<([a-zA-Z_][\\w.-]*)([^>]*)>\\s*([\\w\\W]*?)\\s*<\\/\\1>")
+: BaseParser(data)
 {
 
 }
@@ -11,25 +25,64 @@ ContentParser::ContentParser(const std::string& data)
 std::vector<DataParser> ContentParser::parse()
 {
     std::vector<DataParser> result {};
+    std::string endTag;
+    size_t position = userData.find('<');
 
-    try
+    while (position != std::string::npos)
     {
-        std::sregex_iterator next(userData.begin(), userData.end(), m_RegexValue);
-        std::sregex_iterator end;
-        std::smatch sm;
+        const size_t nameBegin = position + 1;
+        size_t nameEnd = nameBegin;
 
-        while (next != end)
+        if (nameBegin < userData.size() && (std::isalpha(static_cast<unsigned char>(userData[nameBegin])) != 0 ||
+                                            userData[nameBegin] == '_'))
         {
-            sm = *next;
-            DataParser dataParser;
-            dataParser.setContentData(sm[1].str(), sm[2].str(), sm[3].str());
-            result.emplace_back(dataParser);
-            ++next;
+            ++nameEnd;
+
+            while (nameEnd < userData.size() && isNameCharacter(userData[nameEnd]))
+            {
+                ++nameEnd;
+            }
         }
-    }
-    catch (const std::regex_error&)
-    {
-        throw;
+
+        if (nameEnd == nameBegin)
+        {
+            position = userData.find('<', nameBegin);
+            continue;
+        }
+        const size_t tagEnd = userData.find('>', nameEnd);
+
+        if (tagEnd == std::string::npos)
+        {
+            // No start tag after this one is closed either
+            break;
+        }
+        endTag.assign("</").append(userData, nameBegin, nameEnd - nameBegin).append(">");
+        const size_t endTagBegin = userData.find(endTag, tagEnd + 1);
+
+        if (endTagBegin == std::string::npos)
+        {
+            position = userData.find('<', nameBegin);
+            continue;
+        }
+        size_t contentBegin = tagEnd + 1;
+        size_t contentEnd = endTagBegin;
+
+        while (contentBegin < contentEnd && isSpace(userData[contentBegin]))
+        {
+            ++contentBegin;
+        }
+
+        while (contentEnd > contentBegin && isSpace(userData[contentEnd - 1]))
+        {
+            --contentEnd;
+        }
+        const size_t end = endTagBegin + endTag.size();
+        DataParser dataParser;
+        dataParser.setContentData(userData.substr(nameBegin, nameEnd - nameBegin), userData.substr(nameEnd, tagEnd - nameEnd),
+                                  userData.substr(contentBegin, contentEnd - contentBegin));
+        dataParser.setPosition(position, end - position, contentBegin);
+        result.emplace_back(dataParser);
+        position = userData.find('<', end);
     }
     return result;
 }
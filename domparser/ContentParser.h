@@ -2,17 +2,17 @@
 #define DOMPARSER_CONTENTPARSER_H
 
 #include "BaseParser.h"
-#include <regex>
 
+// Finds the elements "<name attributes>content</name>" of the string. An element ends at the
+// first end tag with its name, its content is trimmed. The string is scanned without a regex,
+// whose matcher recursed for every character of the content and overflowed the stack on large
+// or deeply nested pages: neither the size of the content nor the depth is limited now.
 class ContentParser : public BaseParser
 {
 public:
     explicit ContentParser(const std::string&);
     virtual ~ContentParser() = default;
     virtual std::vector<DataParser> parse();
-
-private:
-    std::regex m_RegexValue;
 };
 
 #endif //DOMPARSER_CONTENTPARSER_H
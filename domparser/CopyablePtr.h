@@ -0,0 +1,45 @@
+#ifndef DOMPARSER_COPYABLEPTR_H
+#define DOMPARSER_COPYABLEPTR_H
+
+#include <memory>
+
+// Owning pointer that copies the object together with its owner. Rarely set
+// members are kept behind it, so they take one pointer in the owner and the
+// owner keeps its implicit copy and move.
+template <typename T>
+class CopyablePtr
+{
+public:
+    CopyablePtr() = default;
+    explicit CopyablePtr(T* ptr)
+    : m_Ptr(ptr)
+    {}
+
+    CopyablePtr(const CopyablePtr& right)
+    : m_Ptr(right.m_Ptr ? new T(*right.m_Ptr) : nullptr)
+    {}
+
+    CopyablePtr(CopyablePtr&&) = default;
+
+    CopyablePtr& operator=(const CopyablePtr& right)
+    {
+        if (this != &right)
+        {
+            m_Ptr.reset(right.m_Ptr ? new T(*right.m_Ptr) : nullptr);
+        }
+        return *this;
+    }
+
+    CopyablePtr& operator=(CopyablePtr&&) = default;
+
+    T* get() const { return m_Ptr.get(); }
+    T& operator*() const { return *m_Ptr; }
+    T* operator->() const { return m_Ptr.get(); }
+    explicit operator bool() const { return m_Ptr != nullptr; }
+    void reset(T* ptr = nullptr) { m_Ptr.reset(ptr); }
+
+private:
+    std::unique_ptr<T> m_Ptr {};
+};
+
+#endif //DOMPARSER_COPYABLEPTR_H
@@ -0,0 +1,653 @@
+#include "CssSelectorCompiler.h"
+#include "SelectCssSelector.h"
+
+#include <cctype>
+#include <utility>
+
+namespace
+{
+    using Op = SelectorProgram::Op;
+    using Instruction = SelectorProgram::Instruction;
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    bool isNameCharacter(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '-' || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    int hexValue(char c)
+    {
+        if (isDigit(c))
+        {
+            return c - '0';
+        }
+        return std::tolower(static_cast<unsigned char>(c)) - 'a' + 10;
+    }
+
+    void appendUtf8(std::string& out, uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    // [+-]?[0-9]+, the sign is mandatory for the offset of "an+b"
+    bool parseInteger(const std::string& text, bool signRequired, int32_t& result)
+    {
+        size_t i = 0;
+        bool negative = false;
+
+        if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+        {
+            negative = text[i] == '-';
+            ++i;
+        }
+        else if (signRequired)
+        {
+            return false;
+        }
+
+        if (i == text.size())
+        {
+            return false;
+        }
+        int64_t value = 0;
+
+        for (; i < text.size(); ++i)
+        {
+            if (!isDigit(text[i]))
+            {
+                return false;
+            }
+            // Positions never come close to the limit, larger numbers only have to stay large
+            if (value < 1000000000)
+            {
+                value = value * 10 + (text[i] - '0');
+            }
+        }
+        result = static_cast<int32_t>(negative ? -value : value);
+        return true;
+    }
+
+    Instruction makeInstruction(Op op, AtomTable::Atom atom = AtomTable::None, uint32_t value = 0)
+    {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.atom = atom;
+        instruction.value = value;
+        return instruction;
+    }
+
+    Instruction makeNth(Op op, int32_t a, int32_t b)
+    {
+        Instruction instruction = makeInstruction(op);
+        instruction.a = a;
+        instruction.b = b;
+        return instruction;
+    }
+
+    uint32_t addValue(SelectorProgram& program, const std::string& value)
+    {
+        program.values.push_back(value);
+        return static_cast<uint32_t>(program.values.size() - 1);
+    }
+}
+
+CssSelectorCompiler::CssSelectorCompiler(const std::string& selector)
+: m_Selector(selector)
+{
+
+}
+
+CheckRulesFactory* CssSelectorCompiler::compile() const
+{
+    SelectorProgram program;
+    size_t position = skipSpaces(0);
+
+    while (true)
+    {
+        program.entries.push_back(static_cast<uint32_t>(program.code.size()));
+
+        if (!parseSelector(position, program))
+        {
+            return nullptr;
+        }
+
+        if (position == m_Selector.size())
+        {
+            break;
+        }
+        position = skipSpaces(position + 1);
+    }
+    return new SelectCssSelector(std::move(program));
+}
+
+bool CssSelectorCompiler::parseSelector(size_t& position, SelectorProgram& program) const
+{
+    std::vector<Instructions> compounds;
+    std::vector<Op> combinators;
+
+    while (true)
+    {
+        compounds.emplace_back();
+
+        if (!parseCompound(position, false, program, compounds.back()))
+        {
+            return false;
+        }
+        const size_t next = skipSpaces(position);
+
+        if (next == m_Selector.size() || m_Selector[next] == ',')
+        {
+            position = next;
+            break;
+        }
+
+        switch (m_Selector[next])
+        {
+            case '>':
+                combinators.push_back(Op::Parent);
+                position = skipSpaces(next + 1);
+                break;
+
+            case '+':
+                combinators.push_back(Op::PreviousSibling);
+                position = skipSpaces(next + 1);
+                break;
+
+            case '~':
+                combinators.push_back(Op::AnyPreviousSibling);
+                position = skipSpaces(next + 1);
+                break;
+
+            default:
+                if (next == position)
+                {
+                    return false;
+                }
+                combinators.push_back(Op::Ancestor);
+                position = next;
+                break;
+        }
+    }
+
+    // The rightmost compound is tested first, each combinator then moves to the left
+    for (size_t i = compounds.size(); i-- > 0;)
+    {
+        program.code.insert(program.code.end(), compounds[i].begin(), compounds[i].end());
+
+        if (i > 0)
+        {
+            program.code.push_back(makeInstruction(combinators[i - 1]));
+        }
+    }
+    program.code.push_back(makeInstruction(Op::Match));
+    return true;
+}
+
+bool CssSelectorCompiler::parseCompound(size_t& position, bool negated, SelectorProgram& program, Instructions& out) const
+{
+    const size_t begin = position;
+    // Cheap tests go first so that most tags are rejected by the first instruction
+    Instructions attributes;
+    Instructions structural;
+    std::string name;
+
+    if (position < m_Selector.size() && m_Selector[position] == '*')
+    {
+        ++position;
+    }
+    else if (parseIdentifier(position, name))
+    {
+        out.push_back(makeInstruction(Op::TagName, AtomTable::getGlobal().intern(name)));
+    }
+
+    while (position < m_Selector.size())
+    {
+        const char c = m_Selector[position];
+
+        if (c == '#' || c == '.')
+        {
+            ++position;
+
+            if (!parseIdentifier(position, name))
+            {
+                return false;
+            }
+            attributes.push_back(makeInstruction(c == '#' ? Op::AttributeEquals : Op::AttributeIncludes,
+                                                 AtomTable::getGlobal().intern(c == '#' ? "id" : "class"),
+                                                 addValue(program, name)));
+        }
+        else if (c == '[')
+        {
+            if (!parseAttribute(position, program, attributes))
+            {
+                return false;
+            }
+        }
+        else if (c == ':')
+        {
+            Instructions pseudoClass;
+
+            if (!parsePseudoClass(position, negated, program, pseudoClass))
+            {
+                return false;
+            }
+            Instructions& bucket = pseudoClass.front().op == Op::Not ? attributes : structural;
+            bucket.insert(bucket.end(), pseudoClass.begin(), pseudoClass.end());
+        }
+        else
+        {
+            break;
+        }
+    }
+    out.insert(out.end(), attributes.begin(), attributes.end());
+    out.insert(out.end(), structural.begin(), structural.end());
+    return position != begin;
+}
+
+bool CssSelectorCompiler::parseAttribute(size_t& position, SelectorProgram& program, Instructions& out) const
+{
+    position = skipSpaces(position + 1);
+    std::string name;
+
+    if (!parseIdentifier(position, name))
+    {
+        return false;
+    }
+    position = skipSpaces(position);
+
+    if (position >= m_Selector.size())
+    {
+        return false;
+    }
+    const AtomTable::Atom atom = AtomTable::getGlobal().intern(name);
+
+    if (m_Selector[position] == ']')
+    {
+        ++position;
+        out.push_back(makeInstruction(Op::HasAttribute, atom));
+        return true;
+    }
+    Op op = Op::AttributeEquals;
+    size_t operatorSize = 2;
+
+    switch (m_Selector[position])
+    {
+        case '=': operatorSize = 1; break;
+        case '~': op = Op::AttributeIncludes; break;
+        case '|': op = Op::AttributeDashMatch; break;
+        case '^': op = Op::AttributePrefix; break;
+        case '$': op = Op::AttributeSuffix; break;
+        case '*': op = Op::AttributeSubstring; break;
+        default: return false;
+    }
+
+    if (operatorSize == 2 && (position + 1 >= m_Selector.size() || m_Selector[position + 1] != '='))
+    {
+        return false;
+    }
+    position = skipSpaces(position + operatorSize);
+    std::string value;
+
+    if (position < m_Selector.size() && (m_Selector[position] == '"' || m_Selector[position] == '\''))
+    {
+        if (!parseString(position, value))
+        {
+            return false;
+        }
+    }
+    // Unquoted values should be identifiers, numbers such as [size=5] are accepted as well
+    else if (!parseIdentifier(position, value, true))
+    {
+        return false;
+    }
+    position = skipSpaces(position);
+
+    if (position >= m_Selector.size() || m_Selector[position] != ']')
+    {
+        return false;
+    }
+    ++position;
+    out.push_back(makeInstruction(op, atom, addValue(program, value)));
+    return true;
+}
+
+bool CssSelectorCompiler::parsePseudoClass(size_t& position, bool negated, SelectorProgram& program, Instructions& out) const
+{
+    ++position;
+    std::string name;
+
+    // Pseudo-elements ("::before") fail here
+    if (!parseIdentifier(position, name))
+    {
+        return false;
+    }
+
+    for (auto& c : name)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    if (position < m_Selector.size() && m_Selector[position] == '(')
+    {
+        position = skipSpaces(position + 1);
+
+        if (name == "not")
+        {
+            Instructions block;
+
+            if (negated || !parseCompound(position, true, program, block))
+            {
+                return false;
+            }
+            position = skipSpaces(position);
+
+            if (position >= m_Selector.size() || m_Selector[position] != ')')
+            {
+                return false;
+            }
+            ++position;
+            out.push_back(makeInstruction(Op::Not, AtomTable::None, static_cast<uint32_t>(block.size())));
+            out.insert(out.end(), block.begin(), block.end());
+            return true;
+        }
+        Op op;
+
+        if (name == "nth-child")
+        {
+            op = Op::NthChild;
+        }
+        else if (name == "nth-last-child")
+        {
+            op = Op::NthLastChild;
+        }
+        else if (name == "nth-of-type")
+        {
+            op = Op::NthOfType;
+        }
+        else if (name == "nth-last-of-type")
+        {
+            op = Op::NthLastOfType;
+        }
+        else
+        {
+            return false;
+        }
+        int32_t a = 0;
+        int32_t b = 0;
+
+        if (!parseNth(position, a, b))
+        {
+            return false;
+        }
+        out.push_back(makeNth(op, a, b));
+        return true;
+    }
+
+    if (name == "first-child" || name == "only-child")
+    {
+        out.push_back(makeNth(Op::NthChild, 0, 1));
+    }
+
+    if (name == "last-child" || name == "only-child")
+    {
+        out.push_back(makeNth(Op::NthLastChild, 0, 1));
+    }
+
+    if (name == "first-of-type" || name == "only-of-type")
+    {
+        out.push_back(makeNth(Op::NthOfType, 0, 1));
+    }
+
+    if (name == "last-of-type" || name == "only-of-type")
+    {
+        out.push_back(makeNth(Op::NthLastOfType, 0, 1));
+    }
+
+    if (name == "empty")
+    {
+        out.push_back(makeInstruction(Op::Empty));
+    }
+
+    if (name == "root")
+    {
+        out.push_back(makeInstruction(Op::Root));
+    }
+    return !out.empty();
+}
+
+bool CssSelectorCompiler::parseNth(size_t& position, int32_t& a, int32_t& b) const
+{
+    const size_t end = m_Selector.find(')', position);
+
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    // Whitespace may only surround the argument and the sign between "an" and "b"
+    size_t begin = position;
+    size_t last = end;
+    position = end + 1;
+
+    while (begin < last && isSpace(m_Selector[begin]))
+    {
+        ++begin;
+    }
+
+    while (last > begin && isSpace(m_Selector[last - 1]))
+    {
+        --last;
+    }
+    std::string text;
+
+    for (size_t i = begin; i < last; ++i)
+    {
+        text += static_cast<char>(std::tolower(static_cast<unsigned char>(m_Selector[i])));
+    }
+
+    if (text == "odd" || text == "even")
+    {
+        a = 2;
+        b = text == "odd" ? 1 : 0;
+        return true;
+    }
+    const size_t n = text.find('n');
+
+    if (n == std::string::npos)
+    {
+        a = 0;
+        return parseInteger(text, false, b);
+    }
+    const std::string step = text.substr(0, n);
+    size_t i = n + 1;
+    std::string offset;
+
+    while (i < text.size() && isSpace(text[i]))
+    {
+        ++i;
+    }
+
+    if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+    {
+        offset += text[i++];
+
+        while (i < text.size() && isSpace(text[i]))
+        {
+            ++i;
+        }
+    }
+    // Whitespace left within the numbers is rejected by parseInteger
+    offset.append(text, i, std::string::npos);
+
+    if (step.empty() || step == "+" || step == "-")
+    {
+        a = step == "-" ? -1 : 1;
+    }
+    else if (!parseInteger(step, false, a))
+    {
+        return false;
+    }
+    b = 0;
+    return offset.empty() || parseInteger(offset, true, b);
+}
+
+bool CssSelectorCompiler::parseIdentifier(size_t& position, std::string& out, bool allowDigit) const
+{
+    size_t i = position;
+    std::string name;
+
+    while (i < m_Selector.size())
+    {
+        const char c = m_Selector[i];
+
+        if (isNameCharacter(c))
+        {
+            name += c;
+            ++i;
+        }
+        else if (c == '\\')
+        {
+            if (!parseEscape(i, name))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (name.empty())
+    {
+        return false;
+    }
+    const char first = m_Selector[position];
+
+    // An identifier does not start with a digit, or with a hyphen and a digit
+    if (!allowDigit && (isDigit(first) || (first == '-' && (i == position + 1 || isDigit(m_Selector[position + 1])))))
+    {
+        return false;
+    }
+    out = name;
+    position = i;
+    return true;
+}
+
+bool CssSelectorCompiler::parseString(size_t& position, std::string& out) const
+{
+    const char quote = m_Selector[position];
+    std::string value;
+
+    for (size_t i = position + 1; i < m_Selector.size();)
+    {
+        const char c = m_Selector[i];
+
+        if (c == quote)
+        {
+            out = value;
+            position = i + 1;
+            return true;
+        }
+
+        if (c == '\\')
+        {
+            // An escaped line break continues the string
+            if (i + 1 < m_Selector.size() && m_Selector[i + 1] == '\n')
+            {
+                i += 2;
+            }
+            else if (!parseEscape(i, value))
+            {
+                return false;
+            }
+        }
+        else if (c == '\n')
+        {
+            return false;
+        }
+        else
+        {
+            value += c;
+            ++i;
+        }
+    }
+    return false;
+}
+
+bool CssSelectorCompiler::parseEscape(size_t& position, std::string& out) const
+{
+    size_t i = position + 1;
+
+    if (i >= m_Selector.size() || m_Selector[i] == '\n' || m_Selector[i] == '\r' || m_Selector[i] == '\f')
+    {
+        return false;
+    }
+
+    if (std::isxdigit(static_cast<unsigned char>(m_Selector[i])) != 0)
+    {
+        uint32_t code = 0;
+
+        for (size_t digits = 0; digits < 6 && i < m_Selector.size() && std::isxdigit(static_cast<unsigned char>(m_Selector[i])) != 0; ++digits, ++i)
+        {
+            code = code * 16 + static_cast<uint32_t>(hexValue(m_Selector[i]));
+        }
+
+        // One whitespace character ends the escape and is part of it
+        if (i < m_Selector.size() && isSpace(m_Selector[i]))
+        {
+            ++i;
+        }
+
+        if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+        {
+            code = 0xFFFD;
+        }
+        appendUtf8(out, code);
+    }
+    else
+    {
+        out += m_Selector[i];
+        ++i;
+    }
+    position = i;
+    return true;
+}
+
+size_t CssSelectorCompiler::skipSpaces(size_t position) const
+{
+    while (position < m_Selector.size() && isSpace(m_Selector[position]))
+    {
+        ++position;
+    }
+    return position;
+}
@@ -0,0 +1,42 @@
+#ifndef DOMPARSER_CSSSELECTORCOMPILER_H
+#define DOMPARSER_CSSSELECTORCOMPILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CheckRulesFactory.h"
+#include "SelectorProgram.h"
+
+// Parses a CSS Selectors Level 3 selector list and compiles it to a
+// SelectorProgram: type, universal, #id, .class and attribute selectors,
+// the structural pseudo-classes, :not() and the four combinators.
+// Namespaces, pseudo-elements and dynamic pseudo-classes are not supported.
+class CssSelectorCompiler
+{
+public:
+    explicit CssSelectorCompiler(const std::string&);
+    ~CssSelectorCompiler() = default;
+
+    // Returns nullptr if the selector is incorrect or not supported
+    CheckRulesFactory* compile() const;
+
+private:
+    using Instructions = std::vector<SelectorProgram::Instruction>;
+
+    bool parseSelector(size_t&, SelectorProgram&) const;
+    // Simple selectors without combinators, in matching order
+    bool parseCompound(size_t&, bool, SelectorProgram&, Instructions&) const;
+    bool parseAttribute(size_t&, SelectorProgram&, Instructions&) const;
+    bool parsePseudoClass(size_t&, bool, SelectorProgram&, Instructions&) const;
+    bool parseNth(size_t&, int32_t&, int32_t&) const;
+    bool parseIdentifier(size_t&, std::string&, bool = false) const;
+    bool parseString(size_t&, std::string&) const;
+    bool parseEscape(size_t&, std::string&) const;
+    size_t skipSpaces(size_t) const;
+
+private:
+    std::string m_Selector;
+};
+
+#endif //DOMPARSER_CSSSELECTORCOMPILER_H
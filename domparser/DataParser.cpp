@@ -7,6 +7,12 @@ void DataParser::setContentData(const std::string& tegName, const std::string& n
     m_Content = content;
 }
 
+void DataParser::setPosition(size_t offset, size_t length, size_t contentOffset)
+{
+    m_Offset = offset;
+    m_Length = length;
+    m_ContentOffset = contentOffset;
+}
 
 void DataParser::setTagName(const std::string &str)
 {
@@ -48,3 +54,17 @@ std::string DataParser::getContent() const
     return m_Content;
 }
 
+size_t DataParser::getOffset() const
+{
+    return m_Offset;
+}
+
+size_t DataParser::getLength() const
+{
+    return m_Length;
+}
+
+size_t DataParser::getContentOffset() const
+{
+    return m_ContentOffset;
+}
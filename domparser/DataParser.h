@@ -13,12 +13,17 @@ public:
     void setAttribute(const std::string&);
     void setAttributeValue(const std::string&);
     void setTagName(const std::string &);
+    // Where the element and its content were found in the parsed string
+    void setPosition(size_t, size_t, size_t);
 
     std::string getTagName() const;
     std::string getNotParsingAttributes() const;
     std::string getContent() const;
     std::string getAttribute() const;
     std::string getAttributeValue() const;
+    size_t getOffset() const;
+    size_t getLength() const;
+    size_t getContentOffset() const;
 
 private:
     std::string m_TagName {};
@@ -26,6 +31,9 @@ private:
     std::string m_Content {};
     std::string m_Attribute {};
     std::string m_AttributeValue {};
+    size_t m_Offset = 0;
+    size_t m_Length = 0;
+    size_t m_ContentOffset = 0;
 };
 
 
@@ -0,0 +1,174 @@
+#include "Document.h"
+
+#include <stdexcept>
+
+const uint32_t Document::npos;
+
+Document::Document(Arena& arena)
+: m_Arena(arena)
+{
+
+}
+
+uint32_t Document::append(uint32_t parent)
+{
+    if (m_Nodes.size() >= npos)
+    {
+        throw std::length_error("Document is too large");
+    }
+    const uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+
+    Tag& tag = m_Nodes.emplaceBack(&m_Arena);
+    m_LastChild.emplace_back(npos);
+
+    tag.m_Document = this;
+    tag.m_Index = index;
+    tag.m_ParentIndex = parent;
+    tag.m_SubtreeEnd = index + 1;
+
+    if (parent != npos)
+    {
+        if (m_LastChild[parent] == npos)
+        {
+            m_Nodes[parent].m_FirstChild = index;
+        }
+        else
+        {
+            m_Nodes[m_LastChild[parent]].m_NextSibling = index;
+            tag.m_PreviousSibling = m_LastChild[parent];
+        }
+        m_LastChild[parent] = index;
+    }
+    return index;
+}
+
+void Document::close(uint32_t index)
+{
+    m_Nodes[index].m_SubtreeEnd = static_cast<uint32_t>(m_Nodes.size());
+}
+
+void Document::remove(uint32_t index)
+{
+    Tag& tag = m_Nodes[index];
+
+    if (tag.m_Removed)
+    {
+        return;
+    }
+    const uint32_t parent = tag.m_ParentIndex;
+
+    if (tag.m_PreviousSibling != npos)
+    {
+        m_Nodes[tag.m_PreviousSibling].m_NextSibling = tag.m_NextSibling;
+    }
+    else if (parent != npos)
+    {
+        m_Nodes[parent].m_FirstChild = tag.m_NextSibling;
+    }
+
+    if (tag.m_NextSibling != npos)
+    {
+        m_Nodes[tag.m_NextSibling].m_PreviousSibling = tag.m_PreviousSibling;
+    }
+    else if (parent != npos)
+    {
+        m_LastChild[parent] = tag.m_PreviousSibling;
+    }
+    tag.m_ParentIndex = npos;
+    tag.m_PreviousSibling = npos;
+    tag.m_NextSibling = npos;
+
+    for (uint32_t i = index; i < tag.m_SubtreeEnd; ++i)
+    {
+        if (m_Indexed && !m_Nodes[i].m_Removed)
+        {
+            m_DocumentIndex.remove(m_Nodes[i]);
+        }
+        m_Nodes[i].m_Removed = true;
+    }
+}
+
+void Document::setIndexed(bool indexed)
+{
+    m_Indexed = indexed;
+    m_DocumentIndex.clear();
+
+    if (m_Indexed)
+    {
+        for (const auto& i : m_Nodes)
+        {
+            if (!i.m_Removed)
+            {
+                m_DocumentIndex.add(i);
+            }
+        }
+    }
+}
+
+void Document::indexNode(uint32_t index)
+{
+    if (m_Indexed)
+    {
+        m_DocumentIndex.add(m_Nodes[index]);
+    }
+}
+
+void Document::beginUpdate(uint32_t index)
+{
+    if (m_Indexed && !m_Nodes[index].m_Removed)
+    {
+        m_DocumentIndex.remove(m_Nodes[index]);
+    }
+}
+
+void Document::endUpdate(uint32_t index)
+{
+    if (m_Indexed && !m_Nodes[index].m_Removed)
+    {
+        m_DocumentIndex.add(m_Nodes[index]);
+    }
+}
+
+const DocumentIndex* Document::getDocumentIndex() const
+{
+    return m_Indexed ? &m_DocumentIndex : nullptr;
+}
+
+void Document::reserve(size_t size)
+{
+    m_Nodes.reserve(size);
+    m_LastChild.reserve(size);
+}
+
+void Document::clear()
+{
+    // The capacity is kept for the next document
+    m_Nodes.clear();
+    m_LastChild.clear();
+    m_DocumentIndex.clear();
+}
+
+uint32_t Document::getSize() const
+{
+    return static_cast<uint32_t>(m_Nodes.size());
+}
+
+Tag& Document::getNode(uint32_t index)
+{
+    return m_Nodes[index];
+}
+
+const Tag& Document::getNode(uint32_t index) const
+{
+    return m_Nodes[index];
+}
+
+NodeTable& Document::getNodes()
+{
+    return m_Nodes;
+}
+
+Arena& Document::getArena()
+{
+    return m_Arena;
+}
@@ -0,0 +1,60 @@
+#ifndef DOMPARSER_DOCUMENT_H
+#define DOMPARSER_DOCUMENT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Arena.h"
+#include "DocumentIndex.h"
+#include "NodeTable.h"
+#include "Tag.h"
+
+// Node table of one parsed document. Tags are stored in document order and
+// linked by 32-bit indices (parent, first child, next and previous sibling,
+// subtree end), so linking is O(1). The table grows in chunks: appending never
+// moves a tag, pointers to tags stay valid until clear(). Every subtree is a
+// contiguous index range.
+class Document
+{
+public:
+    static const uint32_t npos = UINT32_MAX;
+
+    explicit Document(Arena&);
+    ~Document() = default;
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    // Adds a tag after all existing ones as the last child of the given parent
+    uint32_t append(uint32_t = npos);
+    // Ends the subtree of the tag after the last tag appended so far
+    void close(uint32_t);
+    // Unlinks the tag and marks its subtree as removed, the indices of the other tags do not change
+    void remove(uint32_t);
+    void reserve(size_t);
+    void clear();
+
+    // The index is optional, tags are added to it by indexNode() once their attributes are set
+    void setIndexed(bool);
+    void indexNode(uint32_t);
+    // Call before and after changing the name or the attributes of an indexed tag
+    void beginUpdate(uint32_t);
+    void endUpdate(uint32_t);
+    // nullptr if the document is not indexed
+    const DocumentIndex* getDocumentIndex() const;
+
+    uint32_t getSize() const;
+    Tag& getNode(uint32_t);
+    const Tag& getNode(uint32_t) const;
+    NodeTable& getNodes();
+    Arena& getArena();
+
+private:
+    Arena& m_Arena;
+    NodeTable m_Nodes {};
+    std::vector<uint32_t> m_LastChild {};
+    bool m_Indexed = false;
+    DocumentIndex m_DocumentIndex {};
+};
+
+#endif //DOMPARSER_DOCUMENT_H
@@ -0,0 +1,241 @@
+#include "DocumentIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+}
+
+size_t DocumentIndex::SpanHash::operator()(const StringSpan& span) const
+{
+    // FNV-1a, ids and class words are short
+    size_t result = 2166136261u;
+    for (size_t i = 0; i < span.size(); ++i)
+    {
+        result = (result ^ static_cast<unsigned char>(span[i])) * 16777619u;
+    }
+    return result;
+}
+
+template <typename Map, typename Key>
+const DocumentIndex::Nodes& DocumentIndex::findHelper(const Map& map, const Key& key)
+{
+    static const Nodes empty {};
+    const auto found = map.find(key);
+    return found == map.end() ? empty : found->second;
+}
+
+template <typename Map, typename Key>
+void DocumentIndex::eraseHelper(Map& map, const Key& key, uint32_t index)
+{
+    auto found = map.find(key);
+
+    if (found != map.end())
+    {
+        auto position = std::lower_bound(found->second.begin(), found->second.end(), index);
+
+        if (position != found->second.end() && *position == index)
+        {
+            found->second.erase(position);
+        }
+
+        if (found->second.empty())
+        {
+            map.erase(found);
+        }
+    }
+}
+
+void DocumentIndex::insertHelper(Nodes& nodes, uint32_t index)
+{
+    // Tags are parsed in document order, so this is an append but for changed tags
+    if (nodes.empty() || nodes.back() < index)
+    {
+        nodes.push_back(index);
+        return;
+    }
+    auto position = std::lower_bound(nodes.begin(), nodes.end(), index);
+
+    if (position == nodes.end() || *position != index)
+    {
+        nodes.insert(position, index);
+    }
+}
+
+DocumentIndex::Nodes& DocumentIndex::wordHelper(WordMap& map, const StringSpan& word)
+{
+    auto found = map.find(word);
+
+    if (found != map.end())
+    {
+        return found->second;
+    }
+    return map[m_Keys.copy(word)];
+}
+
+template <typename Function>
+void DocumentIndex::forEachWord(const StringSpan& value, Function function)
+{
+    for (size_t i = 0; i < value.size();)
+    {
+        if (isSpace(value[i]))
+        {
+            ++i;
+            continue;
+        }
+        const size_t begin = i;
+
+        while (i < value.size() && !isSpace(value[i]))
+        {
+            ++i;
+        }
+        function(StringSpan(value.data() + begin, i - begin));
+    }
+}
+
+void DocumentIndex::add(const Tag& tag)
+{
+    const uint32_t index = tag.getIndex();
+    const AtomTable::Atom tagAtom = tag.getTagAtom();
+    insertHelper(AtomTable::isKnown(tagAtom) ? m_Tags[tagAtom] : wordHelper(m_TagNames, tag.getTagNameView()), index);
+
+    for (size_t i = 0; i < tag.getAttributeCount(); ++i)
+    {
+        const AtomTable::Atom atom = tag.getAttributeAtom(i);
+        insertHelper(AtomTable::isKnown(atom) ? m_Attributes[atom] : wordHelper(m_AttributeNames, tag.getAttributeName(i)),
+                     index);
+
+        if (i >= tag.getAttributeValueCount())
+        {
+            continue;
+        }
+
+        if (atom == m_IdAtom)
+        {
+            insertHelper(wordHelper(m_Ids, tag.getAttributeValue(i)), index);
+        }
+        else if (atom == m_ClassAtom)
+        {
+            forEachWord(tag.getAttributeValue(i), [this, index](const StringSpan& word)
+            {
+                insertHelper(wordHelper(m_Classes, word), index);
+            });
+        }
+    }
+}
+
+void DocumentIndex::remove(const Tag& tag)
+{
+    const uint32_t index = tag.getIndex();
+    const AtomTable::Atom tagAtom = tag.getTagAtom();
+
+    if (AtomTable::isKnown(tagAtom))
+    {
+        eraseHelper(m_Tags, tagAtom, index);
+    }
+    else
+    {
+        eraseHelper(m_TagNames, tag.getTagNameView(), index);
+    }
+
+    for (size_t i = 0; i < tag.getAttributeCount(); ++i)
+    {
+        const AtomTable::Atom atom = tag.getAttributeAtom(i);
+
+        if (AtomTable::isKnown(atom))
+        {
+            eraseHelper(m_Attributes, atom, index);
+        }
+        else
+        {
+            eraseHelper(m_AttributeNames, tag.getAttributeName(i), index);
+        }
+
+        if (i >= tag.getAttributeValueCount())
+        {
+            continue;
+        }
+
+        if (atom == m_IdAtom)
+        {
+            eraseHelper(m_Ids, tag.getAttributeValue(i), index);
+        }
+        else if (atom == m_ClassAtom)
+        {
+            forEachWord(tag.getAttributeValue(i), [this, index](const StringSpan& word)
+            {
+                eraseHelper(m_Classes, word, index);
+            });
+        }
+    }
+}
+
+void DocumentIndex::clear()
+{
+    m_Ids.clear();
+    m_Classes.clear();
+    m_Keys.reset();
+    m_Tags.clear();
+    m_Attributes.clear();
+    m_TagNames.clear();
+    m_AttributeNames.clear();
+}
+
+const DocumentIndex::Nodes& DocumentIndex::getById(const std::string& id) const
+{
+    return findHelper(m_Ids, StringSpan(id));
+}
+
+const DocumentIndex::Nodes& DocumentIndex::getByClass(const std::string& word) const
+{
+    return findHelper(m_Classes, StringSpan(word));
+}
+
+const DocumentIndex::Nodes& DocumentIndex::getByTag(AtomTable::Atom atom) const
+{
+    if (AtomTable::isKnown(atom))
+    {
+        return findHelper(m_Tags, atom);
+    }
+    return findHelper(m_TagNames, AtomTable::getGlobal().getName(atom));
+}
+
+const DocumentIndex::Nodes& DocumentIndex::getByAttribute(AtomTable::Atom atom) const
+{
+    if (AtomTable::isKnown(atom))
+    {
+        return findHelper(m_Attributes, atom);
+    }
+    return findHelper(m_AttributeNames, AtomTable::getGlobal().getName(atom));
+}
+
+const DocumentIndex::Nodes* DocumentIndex::getCandidates(const CheckRulesFactory& rule) const
+{
+    const AtomTable::Atom attribute = rule.getAttributeAtom();
+
+    if (attribute != AtomTable::None)
+    {
+        const std::string* value = rule.getKeyValue();
+
+        if (value != nullptr && attribute == m_IdAtom)
+        {
+            return &getById(*value);
+        }
+
+        if (value != nullptr && attribute == m_ClassAtom)
+        {
+            return &getByClass(*value);
+        }
+        return &getByAttribute(attribute);
+    }
+
+    if (rule.getTagAtom() != AtomTable::None)
+    {
+        return &getByTag(rule.getTagAtom());
+    }
+    return nullptr;
+}
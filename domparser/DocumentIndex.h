@@ -0,0 +1,72 @@
+#ifndef DOMPARSER_DOCUMENTINDEX_H
+#define DOMPARSER_DOCUMENTINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+#include "AtomTable.h"
+#include "CheckRulesFactory.h"
+#include "StringSpan.h"
+#include "Tag.h"
+
+// Optional lookup tables of a Document: id value, class word, tag name and
+// attribute name to the tags that have them. Tags are added as they are
+// parsed and updated one by one when they change, never rebuilt.
+class DocumentIndex
+{
+public:
+    using Nodes = std::vector<uint32_t>; // Indices in the document, in document order
+
+    DocumentIndex() = default;
+    ~DocumentIndex() = default;
+
+    // A changed tag is removed with its old attributes and added again with the new ones
+    void add(const Tag&);
+    void remove(const Tag&);
+    void clear();
+
+    const Nodes& getById(const std::string&) const;
+    const Nodes& getByClass(const std::string&) const;
+    const Nodes& getByTag(AtomTable::Atom) const;
+    const Nodes& getByAttribute(AtomTable::Atom) const;
+    // Every tag the rule can match is among these, nullptr if the rule has no key
+    const Nodes* getCandidates(const CheckRulesFactory&) const;
+
+private:
+    struct SpanHash
+    {
+        size_t operator()(const StringSpan&) const;
+    };
+
+    // Keys are views, their characters are owned by m_Keys
+    using WordMap = std::unordered_map<StringSpan, Nodes, SpanHash>;
+
+    template <typename Map, typename Key>
+    static const Nodes& findHelper(const Map&, const Key&);
+    template <typename Map, typename Key>
+    static void eraseHelper(Map&, const Key&, uint32_t);
+    static void insertHelper(Nodes&, uint32_t);
+    // The list of the word, the word is copied only when it is new
+    Nodes& wordHelper(WordMap&, const StringSpan&);
+    // Calls the function for every whitespace separated word of the value
+    template <typename Function>
+    static void forEachWord(const StringSpan&, Function);
+
+private:
+    Arena m_Keys {4096};
+    WordMap m_Ids {};
+    WordMap m_Classes {};
+    // Known names by atom, other names by their text: a page name gets an atom
+    // only when a rule interns it, which may happen after the tag was indexed
+    std::unordered_map<AtomTable::Atom, Nodes> m_Tags {};
+    std::unordered_map<AtomTable::Atom, Nodes> m_Attributes {};
+    WordMap m_TagNames {};
+    WordMap m_AttributeNames {};
+    AtomTable::Atom m_IdAtom = AtomTable::getGlobal().intern("id");
+    AtomTable::Atom m_ClassAtom = AtomTable::getGlobal().intern("class");
+};
+
+#endif //DOMPARSER_DOCUMENTINDEX_H
@@ -24,6 +24,9 @@ public:
     virtual Tag* current() = 0;
     virtual std::vector<Tag*> children() const = 0;
     virtual std::vector<Tag*> siblings() const = 0;
+    // Queries on every tag of the page, whatever the rule of the object
+    virtual Tag* querySelector(const std::string&) = 0;
+    virtual std::vector<Tag*> querySelectorAll(const std::string&) = 0;
     // Modification
     virtual bool insertAttribute(const std::string&, const std::string&) = 0;
     virtual bool changeAttribute(const std::string&, const std::string&, const std::string&, const std::string&) = 0;
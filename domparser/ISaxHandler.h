@@ -0,0 +1,25 @@
+#ifndef DOMPARSER_ISAXHANDLER_H
+#define DOMPARSER_ISAXHANDLER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Receives the document as a stream of events, no tags are stored.
+// Every callback has an empty default so a handler overrides only what it needs.
+// An element is checked against the rule when it starts, knowing only its ancestors:
+// rules that read siblings or content (":nth-child", "A + B", "A ~ B", ":empty")
+// are rejected with std::logic_error instead of matching wrongly.
+class ISaxHandler
+{
+public:
+    ISaxHandler() = default;
+    virtual ~ISaxHandler() = default;
+
+    virtual void startElement(const std::string&, const std::vector<std::pair<std::string, std::string>>&) {}
+    virtual void endElement(const std::string&) {}
+    virtual void text(const std::string&) {}
+    virtual void comment(const std::string&) {}
+};
+
+#endif //DOMPARSER_ISAXHANDLER_H
@@ -0,0 +1,169 @@
+#include "KnownNames.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr const char* names[] =
+    {
+        "",
+#define DOMPARSER_KNOWN_NAME_STRING(id, name) name,
+        DOMPARSER_KNOWN_NAMES(DOMPARSER_KNOWN_NAME_STRING)
+#undef DOMPARSER_KNOWN_NAME_STRING
+    };
+
+    constexpr size_t nameCount = sizeof(names) / sizeof(names[0]); // Including None
+
+    constexpr size_t roundUp(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // The table is kept at most half full and buckets hold two names on average
+    constexpr size_t tableSize = roundUp(nameCount * 2);
+    constexpr size_t bucketCount = roundUp(nameCount / 2 + 1);
+    constexpr uint32_t seedLimit = 1u << 16;
+
+    constexpr size_t length(const char* str)
+    {
+        size_t result = 0;
+        while (str[result] != '\0')
+        {
+            ++result;
+        }
+        return result;
+    }
+
+    constexpr uint64_t hash(const char* data, size_t size)
+    {
+        uint64_t result = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            result = (result ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+        }
+        return result;
+    }
+
+    // Places the hash in the table with the seed of its bucket
+    constexpr size_t slot(uint64_t hashValue, uint32_t seed)
+    {
+        hashValue ^= (seed + 1) * 0x9E3779B97F4A7C15ull;
+        hashValue ^= hashValue >> 29;
+        hashValue *= 0xBF58476D1CE4E5B9ull;
+        hashValue ^= hashValue >> 32;
+        return static_cast<size_t>(hashValue & (tableSize - 1));
+    }
+
+    struct Table
+    {
+        uint32_t seeds[bucketCount];
+        uint16_t slots[tableSize];  // Index into names, 0 for a free slot
+        uint8_t lengths[nameCount];
+        bool valid;
+    };
+
+    // Hash and displace: the largest buckets are placed first, each one gets
+    // the first seed that moves all its names to free slots.
+    constexpr Table buildTable()
+    {
+        Table table {};
+        uint64_t hashes[nameCount] = {};
+        size_t bucketSizes[bucketCount] = {};
+        size_t candidates[nameCount] = {};
+        size_t maxBucketSize = 0;
+
+        for (size_t i = 1; i < nameCount; ++i)
+        {
+            const size_t size = length(names[i]);
+            table.lengths[i] = static_cast<uint8_t>(size);
+            hashes[i] = hash(names[i], size);
+
+            const size_t bucket = hashes[i] & (bucketCount - 1);
+            ++bucketSizes[bucket];
+            maxBucketSize = bucketSizes[bucket] > maxBucketSize ? bucketSizes[bucket] : maxBucketSize;
+        }
+
+        for (size_t size = maxBucketSize; size > 0; --size)
+        {
+            for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+            {
+                if (bucketSizes[bucket] != size)
+                {
+                    continue;
+                }
+
+                uint32_t seed = 0;
+                for (; seed < seedLimit; ++seed)
+                {
+                    size_t count = 0;
+                    bool placed = true;
+
+                    for (size_t i = 1; i < nameCount && placed; ++i)
+                    {
+                        if ((hashes[i] & (bucketCount - 1)) != bucket)
+                        {
+                            continue;
+                        }
+                        const size_t position = slot(hashes[i], seed);
+                        placed = table.slots[position] == 0;
+
+                        for (size_t j = 0; j < count && placed; ++j)
+                        {
+                            placed = slot(hashes[candidates[j]], seed) != position;
+                        }
+                        candidates[count++] = i;
+                    }
+
+                    if (placed)
+                    {
+                        for (size_t j = 0; j < count; ++j)
+                        {
+                            table.slots[slot(hashes[candidates[j]], seed)] = static_cast<uint16_t>(candidates[j]);
+                        }
+                        table.seeds[bucket] = seed;
+                        break;
+                    }
+                }
+
+                if (seed == seedLimit)
+                {
+                    return table;
+                }
+            }
+        }
+        table.valid = true;
+        return table;
+    }
+
+    constexpr Table table = buildTable();
+    static_assert(table.valid, "Known names do not fit in the perfect hash table");
+    static_assert(nameCount < 65536, "Too many known names");
+}
+
+KnownName KnownNames::find(const StringSpan& name)
+{
+    const uint64_t hashValue = hash(name.data(), name.size());
+    const size_t index = table.slots[slot(hashValue, table.seeds[hashValue & (bucketCount - 1)])];
+
+    if (index != 0 && table.lengths[index] == name.size() && std::memcmp(names[index], name.data(), name.size()) == 0)
+    {
+        return static_cast<KnownName>(index);
+    }
+    return KnownName::None;
+}
+
+StringSpan KnownNames::getName(KnownName name)
+{
+    const size_t index = static_cast<size_t>(name);
+    return index < nameCount ? StringSpan(names[index], table.lengths[index]) : StringSpan();
+}
+
+size_t KnownNames::getCount()
+{
+    return nameCount - 1;
+}
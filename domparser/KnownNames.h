@@ -0,0 +1,303 @@
+#ifndef DOMPARSER_KNOWNNAMES_H
+#define DOMPARSER_KNOWNNAMES_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "StringSpan.h"
+
+// Standard HTML element names
+#define DOMPARSER_HTML_ELEMENT_NAMES(X) \
+    X(A, "a") \
+    X(Abbr, "abbr") \
+    X(Acronym, "acronym") \
+    X(Address, "address") \
+    X(Applet, "applet") \
+    X(Area, "area") \
+    X(Article, "article") \
+    X(Aside, "aside") \
+    X(Audio, "audio") \
+    X(B, "b") \
+    X(Base, "base") \
+    X(Basefont, "basefont") \
+    X(Bdi, "bdi") \
+    X(Bdo, "bdo") \
+    X(Big, "big") \
+    X(Blockquote, "blockquote") \
+    X(Body, "body") \
+    X(Br, "br") \
+    X(Button, "button") \
+    X(Canvas, "canvas") \
+    X(Caption, "caption") \
+    X(Center, "center") \
+    X(Cite, "cite") \
+    X(Code, "code") \
+    X(Col, "col") \
+    X(Colgroup, "colgroup") \
+    X(Data, "data") \
+    X(Datalist, "datalist") \
+    X(Dd, "dd") \
+    X(Del, "del") \
+    X(Details, "details") \
+    X(Dfn, "dfn") \
+    X(Dialog, "dialog") \
+    X(Dir, "dir") \
+    X(Div, "div") \
+    X(Dl, "dl") \
+    X(Dt, "dt") \
+    X(Em, "em") \
+    X(Embed, "embed") \
+    X(Fieldset, "fieldset") \
+    X(Figcaption, "figcaption") \
+    X(Figure, "figure") \
+    X(Font, "font") \
+    X(Footer, "footer") \
+    X(Form, "form") \
+    X(Frame, "frame") \
+    X(Frameset, "frameset") \
+    X(H1, "h1") \
+    X(H2, "h2") \
+    X(H3, "h3") \
+    X(H4, "h4") \
+    X(H5, "h5") \
+    X(H6, "h6") \
+    X(Head, "head") \
+    X(Header, "header") \
+    X(Hgroup, "hgroup") \
+    X(Hr, "hr") \
+    X(Html, "html") \
+    X(I, "i") \
+    X(Iframe, "iframe") \
+    X(Img, "img") \
+    X(Input, "input") \
+    X(Ins, "ins") \
+    X(Kbd, "kbd") \
+    X(Label, "label") \
+    X(Legend, "legend") \
+    X(Li, "li") \
+    X(Link, "link") \
+    X(Main, "main") \
+    X(Map, "map") \
+    X(Mark, "mark") \
+    X(Marquee, "marquee") \
+    X(Math, "math") \
+    X(Menu, "menu") \
+    X(Meta, "meta") \
+    X(Meter, "meter") \
+    X(Nav, "nav") \
+    X(Noframes, "noframes") \
+    X(Noscript, "noscript") \
+    X(Object, "object") \
+    X(Ol, "ol") \
+    X(Optgroup, "optgroup") \
+    X(Option, "option") \
+    X(Output, "output") \
+    X(P, "p") \
+    X(Param, "param") \
+    X(Picture, "picture") \
+    X(Pre, "pre") \
+    X(Progress, "progress") \
+    X(Q, "q") \
+    X(Rp, "rp") \
+    X(Rt, "rt") \
+    X(Ruby, "ruby") \
+    X(S, "s") \
+    X(Samp, "samp") \
+    X(Script, "script") \
+    X(Search, "search") \
+    X(Section, "section") \
+    X(Select, "select") \
+    X(Slot, "slot") \
+    X(Small, "small") \
+    X(Source, "source") \
+    X(Span, "span") \
+    X(Strike, "strike") \
+    X(Strong, "strong") \
+    X(Style, "style") \
+    X(Sub, "sub") \
+    X(Summary, "summary") \
+    X(Sup, "sup") \
+    X(Svg, "svg") \
+    X(Table, "table") \
+    X(Tbody, "tbody") \
+    X(Td, "td") \
+    X(Template, "template") \
+    X(Textarea, "textarea") \
+    X(Tfoot, "tfoot") \
+    X(Th, "th") \
+    X(Thead, "thead") \
+    X(Time, "time") \
+    X(Title, "title") \
+    X(Tr, "tr") \
+    X(Track, "track") \
+    X(Tt, "tt") \
+    X(U, "u") \
+    X(Ul, "ul") \
+    X(Var, "var") \
+    X(Video, "video") \
+    X(Wbr, "wbr")
+
+// Standard HTML attribute names not already listed as elements
+#define DOMPARSER_HTML_ATTRIBUTE_NAMES(X) \
+    X(Accept, "accept") \
+    X(AcceptCharset, "accept-charset") \
+    X(Accesskey, "accesskey") \
+    X(Action, "action") \
+    X(Align, "align") \
+    X(Allow, "allow") \
+    X(Alt, "alt") \
+    X(AriaHidden, "aria-hidden") \
+    X(AriaLabel, "aria-label") \
+    X(Async, "async") \
+    X(Autocapitalize, "autocapitalize") \
+    X(Autocomplete, "autocomplete") \
+    X(Autofocus, "autofocus") \
+    X(Autoplay, "autoplay") \
+    X(Background, "background") \
+    X(Bgcolor, "bgcolor") \
+    X(Border, "border") \
+    X(Charset, "charset") \
+    X(Checked, "checked") \
+    X(Class, "class") \
+    X(Color, "color") \
+    X(Cols, "cols") \
+    X(Colspan, "colspan") \
+    X(Content, "content") \
+    X(Contenteditable, "contenteditable") \
+    X(Controls, "controls") \
+    X(Coords, "coords") \
+    X(Crossorigin, "crossorigin") \
+    X(Datetime, "datetime") \
+    X(Decoding, "decoding") \
+    X(Default, "default") \
+    X(Defer, "defer") \
+    X(Dirname, "dirname") \
+    X(Disabled, "disabled") \
+    X(Download, "download") \
+    X(Draggable, "draggable") \
+    X(Enctype, "enctype") \
+    X(Enterkeyhint, "enterkeyhint") \
+    X(For, "for") \
+    X(Formaction, "formaction") \
+    X(Formenctype, "formenctype") \
+    X(Formmethod, "formmethod") \
+    X(Formnovalidate, "formnovalidate") \
+    X(Formtarget, "formtarget") \
+    X(Headers, "headers") \
+    X(Height, "height") \
+    X(Hidden, "hidden") \
+    X(High, "high") \
+    X(Href, "href") \
+    X(Hreflang, "hreflang") \
+    X(HttpEquiv, "http-equiv") \
+    X(Id, "id") \
+    X(Inert, "inert") \
+    X(Inputmode, "inputmode") \
+    X(Integrity, "integrity") \
+    X(Is, "is") \
+    X(Ismap, "ismap") \
+    X(Itemprop, "itemprop") \
+    X(Itemscope, "itemscope") \
+    X(Itemtype, "itemtype") \
+    X(Kind, "kind") \
+    X(Lang, "lang") \
+    X(Language, "language") \
+    X(List, "list") \
+    X(Loading, "loading") \
+    X(Loop, "loop") \
+    X(Low, "low") \
+    X(Max, "max") \
+    X(Maxlength, "maxlength") \
+    X(Media, "media") \
+    X(Method, "method") \
+    X(Min, "min") \
+    X(Minlength, "minlength") \
+    X(Multiple, "multiple") \
+    X(Muted, "muted") \
+    X(Name, "name") \
+    X(Nomodule, "nomodule") \
+    X(Nonce, "nonce") \
+    X(Novalidate, "novalidate") \
+    X(Onblur, "onblur") \
+    X(Onchange, "onchange") \
+    X(Onclick, "onclick") \
+    X(Onerror, "onerror") \
+    X(Onfocus, "onfocus") \
+    X(Oninput, "oninput") \
+    X(Onkeydown, "onkeydown") \
+    X(Onkeyup, "onkeyup") \
+    X(Onload, "onload") \
+    X(Onmouseover, "onmouseover") \
+    X(Onsubmit, "onsubmit") \
+    X(Open, "open") \
+    X(Optimum, "optimum") \
+    X(Pattern, "pattern") \
+    X(Ping, "ping") \
+    X(Placeholder, "placeholder") \
+    X(Playsinline, "playsinline") \
+    X(Popover, "popover") \
+    X(Poster, "poster") \
+    X(Preload, "preload") \
+    X(Readonly, "readonly") \
+    X(Referrerpolicy, "referrerpolicy") \
+    X(Rel, "rel") \
+    X(Required, "required") \
+    X(Reversed, "reversed") \
+    X(Role, "role") \
+    X(Rows, "rows") \
+    X(Rowspan, "rowspan") \
+    X(Sandbox, "sandbox") \
+    X(Scope, "scope") \
+    X(Selected, "selected") \
+    X(Shape, "shape") \
+    X(Size, "size") \
+    X(Sizes, "sizes") \
+    X(Spellcheck, "spellcheck") \
+    X(Src, "src") \
+    X(Srcdoc, "srcdoc") \
+    X(Srclang, "srclang") \
+    X(Srcset, "srcset") \
+    X(Start, "start") \
+    X(Step, "step") \
+    X(Tabindex, "tabindex") \
+    X(Target, "target") \
+    X(Translate, "translate") \
+    X(Type, "type") \
+    X(Usemap, "usemap") \
+    X(Value, "value") \
+    X(Width, "width") \
+    X(Wrap, "wrap") \
+    X(Xmlns, "xmlns")
+
+// Names of our XML dialects can be added at build time, in the same form:
+// -DDOMPARSER_USER_NAMES(X)='X(Catalog, "catalog") X(Item, "item")'
+#ifndef DOMPARSER_USER_NAMES
+#define DOMPARSER_USER_NAMES(X)
+#endif
+
+#define DOMPARSER_KNOWN_NAMES(X) \
+    DOMPARSER_HTML_ELEMENT_NAMES(X) \
+    DOMPARSER_HTML_ATTRIBUTE_NAMES(X) \
+    DOMPARSER_USER_NAMES(X)
+
+// The values are also the atoms of these names in every AtomTable
+enum class KnownName : uint32_t
+{
+    None = 0,
+#define DOMPARSER_KNOWN_NAME_ENUM(id, name) id,
+    DOMPARSER_KNOWN_NAMES(DOMPARSER_KNOWN_NAME_ENUM)
+#undef DOMPARSER_KNOWN_NAME_ENUM
+};
+
+// Perfect hash over the known names, built at compile time. A lookup costs
+// one hash of the name and one comparison, without locking or probing.
+class KnownNames
+{
+public:
+    // None if the name is not known
+    static KnownName find(const StringSpan&);
+    static StringSpan getName(KnownName);
+    static size_t getCount();
+};
+
+#endif //DOMPARSER_KNOWNNAMES_H
@@ -0,0 +1,110 @@
+#ifndef DOMPARSER_NODETABLE_H
+#define DOMPARSER_NODETABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "Tag.h"
+
+// Tags of a document indexed by position. They are stored in fixed-size
+// chunks, so a tag never moves once appended and pointers to it stay valid
+// until the table is cleared. clear() keeps the chunks for the next document.
+class NodeTable
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(NodeTable* table, uint32_t index)
+        : m_Table(table),
+          m_Index(index)
+        {}
+
+        Tag& operator*() const { return (*m_Table)[m_Index]; }
+        Tag* operator->() const { return &(*m_Table)[m_Index]; }
+        Iterator& operator++() { ++m_Index; return *this; }
+        bool operator!=(const Iterator& right) const { return m_Index != right.m_Index; }
+
+    private:
+        NodeTable* m_Table;
+        uint32_t m_Index;
+    };
+
+public:
+    NodeTable() = default;
+    ~NodeTable()
+    {
+        clear();
+    }
+
+    NodeTable(const NodeTable&) = delete;
+    NodeTable& operator=(const NodeTable&) = delete;
+
+    Tag& operator[](uint32_t index)
+    {
+        return reinterpret_cast<Tag*>(m_Chunks[index >> ChunkBits].get())[index & ChunkMask];
+    }
+
+    const Tag& operator[](uint32_t index) const
+    {
+        return reinterpret_cast<const Tag*>(m_Chunks[index >> ChunkBits].get())[index & ChunkMask];
+    }
+
+    Tag& emplaceBack(Arena* arena)
+    {
+        reserve(m_Size + 1);
+        Tag* tag = new (&(*this)[m_Size]) Tag(arena);
+        ++m_Size;
+        return *tag;
+    }
+
+    Tag& back()
+    {
+        return (*this)[m_Size - 1];
+    }
+
+    size_t size() const
+    {
+        return m_Size;
+    }
+
+    bool empty() const
+    {
+        return m_Size == 0;
+    }
+
+    void reserve(size_t size)
+    {
+        while (m_Chunks.size() * ChunkSize < size)
+        {
+            m_Chunks.emplace_back(new Slot[ChunkSize]);
+        }
+    }
+
+    void clear()
+    {
+        for (uint32_t i = 0; i < m_Size; ++i)
+        {
+            (*this)[i].~Tag();
+        }
+        m_Size = 0;
+    }
+
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end() { return Iterator(this, static_cast<uint32_t>(m_Size)); }
+
+private:
+    static const uint32_t ChunkBits = 9;
+    static const uint32_t ChunkSize = 1u << ChunkBits;
+    static const uint32_t ChunkMask = ChunkSize - 1;
+
+    using Slot = typename std::aligned_storage<sizeof(Tag), alignof(Tag)>::type;
+
+    std::vector<std::unique_ptr<Slot[]>> m_Chunks {};
+    size_t m_Size = 0;
+};
+
+#endif //DOMPARSER_NODETABLE_H
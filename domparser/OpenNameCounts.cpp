@@ -0,0 +1,64 @@
+#include "OpenNameCounts.h"
+
+#include <algorithm>
+
+#include "KnownNames.h"
+
+OpenNameCounts::OpenNameCounts()
+: m_Known(KnownNames::getCount() + 1, 0)
+{
+
+}
+
+void OpenNameCounts::add(const StringSpan& name)
+{
+    const KnownName known = KnownNames::find(name);
+
+    if (known != KnownName::None)
+    {
+        ++m_Known[static_cast<size_t>(known)];
+        return;
+    }
+    m_Key.assign(name.data(), name.size());
+    ++m_Other[m_Key];
+}
+
+void OpenNameCounts::remove(const StringSpan& name)
+{
+    const KnownName known = KnownNames::find(name);
+
+    if (known != KnownName::None)
+    {
+        --m_Known[static_cast<size_t>(known)];
+        return;
+    }
+    m_Key.assign(name.data(), name.size());
+    auto found = m_Other.find(m_Key);
+
+    if (found != m_Other.end() && --found->second == 0)
+    {
+        m_Other.erase(found);
+    }
+}
+
+bool OpenNameCounts::contains(const StringSpan& name) const
+{
+    const KnownName known = KnownNames::find(name);
+
+    if (known != KnownName::None)
+    {
+        return m_Known[static_cast<size_t>(known)] != 0;
+    }
+    if (m_Other.empty())
+    {
+        return false;
+    }
+    m_Key.assign(name.data(), name.size());
+    return m_Other.find(m_Key) != m_Other.end();
+}
+
+void OpenNameCounts::clear()
+{
+    std::fill(m_Known.begin(), m_Known.end(), 0);
+    m_Other.clear();
+}
@@ -0,0 +1,31 @@
+#ifndef DOMPARSER_OPENNAMECOUNTS_H
+#define DOMPARSER_OPENNAMECOUNTS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "StringSpan.h"
+
+// Number of open elements per tag name, so that an end tag without a matching
+// open element is dropped without walking the chain of open elements.
+// Known names are counted by their index, other names by their text.
+class OpenNameCounts
+{
+public:
+    OpenNameCounts();
+    ~OpenNameCounts() = default;
+
+    void add(const StringSpan&);
+    void remove(const StringSpan&);
+    bool contains(const StringSpan&) const;
+    void clear();
+
+private:
+    std::vector<uint32_t> m_Known;
+    std::unordered_map<std::string, uint32_t> m_Other {};
+    mutable std::string m_Key {}; // Reused to look up the other names
+};
+
+#endif //DOMPARSER_OPENNAMECOUNTS_H
@@ -1,10 +1,15 @@
 #include "PageDataImpl.h"
+#include "SelectorCache.h"
+
+#include <algorithm>
 #include <functional>
 #include <iterator>
+#include <stdexcept>
 
 PageDataImpl::PageDataImpl(const std::string& path, const std::string& rules)
 : m_ProcessPage(path, rules)
 {
+    m_ProcessPage.setIndexing(true);
     m_ProcessPage.process();
     m_Data = std::move(m_ProcessPage.getPageData());
 }
@@ -31,11 +36,8 @@ size_t PageDataImpl::getCurrentTagNumber() const
 
 bool PageDataImpl::compareTags(const Tag& lTag, Tag* rTag) const
 {
-    return lTag.getTagName() == rTag->getTagName() &&
-           lTag.getParent() == rTag->getParent() &&
-           lTag.getAttributeTag() == rTag->getAttributeTag() &&
-           lTag.getAttributeValueTag() == rTag->getAttributeValueTag() &&
-           lTag.getContent() == rTag->getContent();
+    // Compared in place, the attribute copies of the const accessors are not needed
+    return rTag != nullptr && *rTag == lTag;
 }
 
 Tag* PageDataImpl::first()
@@ -107,20 +109,11 @@ std::vector<Tag*> PageDataImpl::siblings() const
     if (!m_Data.empty())
     {
         auto parent = m_Data[m_CurrentTag].getParent();
-        auto position = std::find_if(m_Data.begin(), m_Data.end(),
-                                     [&parent](const Tag &tag)
-                                     {
-                                         return tag.getTagName() == parent->getTagName() &&
-                                                tag.getParent() == parent->getParent() &&
-                                                tag.getAttributeTag() == parent->getAttributeTag() &&
-                                                tag.getAttributeValueTag() == parent->getAttributeValueTag() &&
-                                                tag.getContent() == parent->getContent();
-                                     });
-
         if (parent != nullptr)
         {
-            std::vector<Tag *> children = position->getChildren();
-            for (const auto &i : children)
+            // The parent links its children in the document, it does not need to be among the selected tags
+            std::vector<Tag*> children = parent->getChildren();
+            for (const auto& i : children)
             {
                 if (!compareTags(m_Data[m_CurrentTag], i))
                 {
@@ -132,12 +125,126 @@ std::vector<Tag*> PageDataImpl::siblings() const
     return result;
 }
 
+std::shared_ptr<const CheckRulesFactory> PageDataImpl::compileHelper(const std::string& rule) const
+{
+    auto compiled = SelectorCache::getGlobal().get(rule);
+    if (compiled == nullptr)
+    {
+        throw std::logic_error("Rule is incorrect");
+    }
+    return compiled;
+}
+
+Tag* PageDataImpl::querySelector(const std::string& rule)
+{
+    auto result = selectHelper(rule, 1);
+    return result.empty() ? nullptr : result.front();
+}
+
+std::vector<Tag*> PageDataImpl::querySelectorAll(const std::string& rule)
+{
+    return selectHelper(rule, m_ProcessPage.getDocument().getSize());
+}
+
+std::vector<Tag*> PageDataImpl::selectHelper(const std::string& rule, size_t limit)
+{
+    auto compiled = compileHelper(rule);
+    Document& document = m_ProcessPage.getDocument();
+    std::vector<Tag*> result {};
+
+    std::vector<uint32_t> indices {};
+
+    // A rule with a key only needs to test the tags the index lists for it
+    const DocumentIndex::Nodes* candidates = document.getDocumentIndex() != nullptr ?
+                                             document.getDocumentIndex()->getCandidates(*compiled) : nullptr;
+    if (candidates != nullptr)
+    {
+        compiled->selectNodes(document, *candidates, indices, limit);
+    }
+    else
+    {
+        compiled->selectNodes(document, indices, limit);
+    }
+    result.reserve(indices.size());
+
+    for (const auto i : indices)
+    {
+        result.emplace_back(&document.getNode(i));
+    }
+    return result;
+}
+
+Tag* PageDataImpl::documentNodeHelper(const Tag& tag)
+{
+    Document& document = m_ProcessPage.getDocument();
+    if (tag.getDocument() == &document && tag.getIndex() < document.getSize() && !document.getNode(tag.getIndex()).isRemoved())
+    {
+        return &document.getNode(tag.getIndex());
+    }
+    return nullptr;
+}
+
+void PageDataImpl::modifyHelper(const std::function<void(Tag&)>& modify)
+{
+    // The change is written through to the tag of the document, which queries and the index see
+    Tag* node = documentNodeHelper(m_Data[m_CurrentTag]);
+    modify(m_Data[m_CurrentTag]);
+
+    if (node != nullptr)
+    {
+        m_ProcessPage.getDocument().beginUpdate(node->getIndex());
+        modify(*node);
+        m_ProcessPage.getDocument().endUpdate(node->getIndex());
+    }
+}
+
+Tag PageDataImpl::adoptHelper(const Tag& tag)
+{
+    Tag copy(m_ProcessPage.getDocument().getNode(adoptNodeHelper(tag, Document::npos)));
+    copy.setOwner(m_ProcessPage.getDocumentOwner());
+    return copy;
+}
+
+uint32_t PageDataImpl::adoptNodeHelper(const Tag& tag, uint32_t parent)
+{
+    // The tag may be one of the document, appending does not move it
+    Document& document = m_ProcessPage.getDocument();
+    const uint32_t index = document.append(parent);
+    Tag& node = document.getNode(index);
+
+    node.setTagName(tag.getTagName());
+    node.setContent(tag.getContent());
+    for (size_t i = 0; i < tag.getAttributeCount(); ++i)
+    {
+        node.setAttributeTag(tag.getAttributeName(i).str());
+    }
+    for (size_t i = 0; i < tag.getAttributeValueCount(); ++i)
+    {
+        node.setAttributeValueTag(tag.getAttributeValue(i).str());
+    }
+    document.indexNode(index);
+
+    // The subtree of a document tag stays where it is, a tree built outside of one is added whole
+    if (tag.getDocument() == nullptr)
+    {
+        for (const Tag* i : tag.getChildren())
+        {
+            adoptNodeHelper(*i, index);
+        }
+    }
+    document.close(index);
+    return index;
+}
+
 bool PageDataImpl::insertAttribute(const std::string& attributeName, const std::string& attributeValue)
 {
     if (!m_Data.empty())
     {
-        m_Data[m_CurrentTag].setAttributeTag(attributeName);
-        m_Data[m_CurrentTag].setAttributeValueTag(attributeValue);
+        modifyHelper([&](Tag& tag)
+                     {
+                         tag.setAttributeTag(attributeName);
+                         tag.setAttributeValueTag(attributeValue);
+                     });
         return true;
     }
     return false;
@@ -147,20 +254,15 @@ bool PageDataImpl::changeAttribute(const std::string& attributeOldName, const st
 {
     if (!m_Data.empty())
     {
-        auto attributes = &m_Data[m_CurrentTag].getAttributeTag();
-        auto attributePosition = std::find(attributes->begin(), attributes->end(), attributeOldName);
-        if (attributePosition != attributes->end())
+        const size_t position = findAttributeHelper(m_Data[m_CurrentTag], attributeOldName, attributeOldValue);
+        if (position != std::string::npos)
         {
-            auto attributeValue = &m_Data[m_CurrentTag].getAttributeValueTag();
-            auto attributeValuePosition = std::find(attributeValue->begin(), attributeValue->end(), attributeOldValue);
-
-            if (attributeValuePosition != attributeValue->end() &&
-                std::distance(attributes->begin(), attributePosition) == std::distance(attributeValue->begin(), attributeValuePosition))
-            {
-                *attributePosition = attributeNewName;
-                *attributeValuePosition = attributeNewValue;
-                return true;
-            }
+            // Only the changed pair is copied, the other attributes keep referring to the page
+            modifyHelper([&](Tag& tag)
+                         {
+                             tag.replaceAttribute(position, attributeNewName, attributeNewValue);
+                         });
+            return true;
         }
     }
     return false;
@@ -170,42 +272,51 @@ bool PageDataImpl::removeAttribute(const std::string& attributeName, const std::
 {
     if (!m_Data.empty())
     {
-        auto attributesPtr = &m_Data[m_CurrentTag].getAttributeTag();
-        auto attributesValuePtr = &m_Data[m_CurrentTag].getAttributeValueTag();
-        auto attributePosition = std::find(attributesPtr->begin(), attributesPtr->end(), attributeName);
-        auto attributeValuePosition = std::find(attributesValuePtr->begin(), attributesValuePtr->end(), attributeValue);
-
-        if (attributePosition != attributesPtr->end() && attributeValuePosition != attributesValuePtr->end()
-            && std::distance(attributesPtr->begin(), attributePosition) == std::distance(attributesValuePtr->begin(), attributeValuePosition))
+        const size_t position = findAttributeHelper(m_Data[m_CurrentTag], attributeName, attributeValue);
+        if (position != std::string::npos)
         {
-            auto attributeNextPosition = attributePosition;
-            ++attributeNextPosition;
-            auto attributeValueNextPosition = attributeValuePosition;
-            ++attributeValueNextPosition;
-
-            while (attributeNextPosition != attributesPtr->end() && attributeValueNextPosition != attributesValuePtr->end())
-            {
-                *attributePosition++ = *attributeNextPosition++;
-                *attributeValuePosition++ = *attributeValueNextPosition++;
-            }
-            attributesPtr->erase(attributePosition, attributesPtr->end());
-            attributesValuePtr->erase(attributeValuePosition, attributesValuePtr->end());
+            modifyHelper([position](Tag& tag)
+                         {
+                             tag.eraseAttribute(position);
+                         });
             return true;
         }
     }
     return false;
 }
 
+size_t PageDataImpl::findAttributeHelper(const Tag& tag, const std::string& attributeName, const std::string& attributeValue) const
+{
+    // The first attribute with the name must also be the first one with the value
+    size_t namePosition = 0;
+    while (namePosition < tag.getAttributeCount() && tag.getAttributeName(namePosition) != attributeName)
+    {
+        ++namePosition;
+    }
+
+    size_t valuePosition = 0;
+    while (valuePosition < tag.getAttributeValueCount() && tag.getAttributeValue(valuePosition) != attributeValue)
+    {
+        ++valuePosition;
+    }
+
+    if (namePosition < tag.getAttributeCount() && namePosition == valuePosition)
+    {
+        return namePosition;
+    }
+    return std::string::npos;
+}
+
 void PageDataImpl::pushBack(const Tag& tag)
 {
-    m_Data.emplace_back(tag);
+    m_Data.emplace_back(adoptHelper(tag));
 }
 
 void PageDataImpl::pushFront(const Tag& tag)
 {
     std::vector<Tag> temp;
     temp.reserve(m_Data.size() + 1);
-    temp.emplace_back(tag);
+    temp.emplace_back(adoptHelper(tag));
     for (const auto& i : m_Data)
     {
         temp.emplace_back(i);
@@ -218,7 +329,7 @@ bool PageDataImpl::pushBefore(const Tag& existTag, const Tag& newTag)
     auto position = std::find(m_Data.begin(), m_Data.end(), existTag);
     if (position != m_Data.end())
     {
-        m_Data.insert(position, newTag);
+        m_Data.insert(position, adoptHelper(newTag));
         return true;
     }
     return false;
@@ -229,7 +340,7 @@ bool PageDataImpl::pushBefore(size_t index, const Tag& newTag)
     if (index < m_Data.size())
     {
         auto position = m_Data.begin() + index;
-        m_Data.insert(position, newTag);
+        m_Data.insert(position, adoptHelper(newTag));
         return true;
     }
     return false;
@@ -240,7 +351,7 @@ bool PageDataImpl::pushAfter(const Tag& existTag, const Tag& newTag)
     auto position = std::find(m_Data.begin(), m_Data.end(), existTag);
     if (position != m_Data.end())
     {
-        m_Data.insert(++position, newTag);
+        m_Data.insert(++position, adoptHelper(newTag));
         return true;
     }
     return false;
@@ -251,7 +362,7 @@ bool PageDataImpl::pushAfter(size_t index, const Tag& newTag)
     if (index < m_Data.size())
     {
         auto position = m_Data.begin() + index;
-        m_Data.insert(++position, newTag);
+        m_Data.insert(++position, adoptHelper(newTag));
         return true;
     }
     return false;
@@ -261,7 +372,10 @@ bool PageDataImpl::changeContent(const std::string& newContent)
 {
     if (!m_Data.empty())
     {
-        m_Data[m_CurrentTag].setContent(newContent);
+        modifyHelper([&newContent](Tag& tag)
+                     {
+                         tag.setContent(newContent);
+                     });
         return true;
     }
     return false;
@@ -271,7 +385,10 @@ bool PageDataImpl::removeContent()
 {
     if (!m_Data.empty())
     {
-        m_Data[m_CurrentTag].setContent("");
+        modifyHelper([](Tag& tag)
+                     {
+                         tag.setContent("");
+                     });
         return true;
     }
     return false;
@@ -281,6 +398,11 @@ bool PageDataImpl::removeTag()
 {
     if (!m_Data.empty())
     {
+        Tag* node = documentNodeHelper(m_Data[m_CurrentTag]);
+        if (node != nullptr)
+        {
+            m_ProcessPage.getDocument().remove(node->getIndex());
+        }
         m_Data.erase(std::remove_if(m_Data.begin(), m_Data.end(),
                                     [this](Tag &tag)
                                     {
@@ -317,12 +439,13 @@ std::string PageDataImpl::getAttributeValue(const std::string& attribute) const
 {
     if (!m_Data.empty())
     {
-        auto tagAttributes = m_Data[m_CurrentTag].getAttributeTag();
-        auto position = std::find(tagAttributes.begin(), tagAttributes.end(), attribute);
-        if (position != tagAttributes.end())
+        const Tag& tag = m_Data[m_CurrentTag];
+        for (size_t i = 0; i < tag.getAttributeCount(); ++i)
         {
-            auto tagAttributesValue = m_Data[m_CurrentTag].getAttributeValueTag();
-            return tagAttributesValue[std::distance(tagAttributes.begin(), position)];
+            if (tag.getAttributeName(i) == attribute && i < tag.getAttributeValueCount())
+            {
+                return tag.getAttributeValue(i).str();
+            }
         }
     }
     return {};
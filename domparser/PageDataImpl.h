@@ -1,6 +1,8 @@
 #ifndef DOMPARSER_PAGEDATAIMPL_H
 #define DOMPARSER_PAGEDATAIMPL_H
 
+#include <functional>
+
 #include "IPageData.h"
 #include "ProcessPage.h"
 
@@ -22,7 +24,12 @@ public:
     virtual Tag* current();
     virtual std::vector<Tag*> children() const;
     virtual std::vector<Tag*> siblings() const;
-    // Modification
+    // Queries on every tag of the page, whatever the rule of the object.
+    // Throw std::logic_error if the rule is incorrect.
+    virtual Tag* querySelector(const std::string&);
+    virtual std::vector<Tag*> querySelectorAll(const std::string&);
+    // Modification. Changes of the current tag are made to the tag of the document as well,
+    // pushed tags are added to the document as new top-level tags.
     virtual bool insertAttribute(const std::string&, const std::string&);
     virtual bool changeAttribute(const std::string&, const std::string&, const std::string&, const std::string&);
     virtual bool removeAttribute(const std::string&, const std::string&);
@@ -42,9 +49,20 @@ public:
 
 private:
     bool compareTags(const Tag&, Tag*) const;
+    // Index of the attribute with the given name and value, npos if there is none
+    size_t findAttributeHelper(const Tag&, const std::string&, const std::string&) const;
+    std::shared_ptr<const CheckRulesFactory> compileHelper(const std::string&) const;
+    std::vector<Tag*> selectHelper(const std::string&, size_t);
+    // The tag of the document a selected tag is a copy of, nullptr if there is none
+    Tag* documentNodeHelper(const Tag&);
+    void modifyHelper(const std::function<void(Tag&)>&);
+    // Adds a new top-level tag to the document, returns the copy to select
+    Tag adoptHelper(const Tag&);
+    // Appends the tag to the document, with the children linked to a tag outside of one
+    uint32_t adoptNodeHelper(const Tag&, uint32_t);
 
 private:
-    ProcessPage m_ProcessPage;
+    ProcessPage m_ProcessPage; // Owns the mapped page and every parsed tag, which live as long as this object
     std::vector<Tag> m_Data;
     size_t m_CurrentTag = 0;
 };
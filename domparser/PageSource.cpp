@@ -0,0 +1,154 @@
+#include "PageSource.h"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+PageSource::PageSource(const std::string& data)
+: m_Buffer(data)
+{
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+}
+
+PageSource::~PageSource()
+{
+    release();
+}
+
+bool PageSource::open(const std::string& path)
+{
+    release();
+    return mapFile(path) || readFile(path);
+}
+
+const char* PageSource::getData() const
+{
+    return m_Data;
+}
+
+size_t PageSource::getSize() const
+{
+    return m_Size;
+}
+
+bool PageSource::empty() const
+{
+    return m_Size == 0;
+}
+
+bool PageSource::isMapped() const
+{
+    return m_Mapping != nullptr;
+}
+
+#if defined(_WIN32)
+bool PageSource::mapFile(const std::string& path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_Mapping = view;
+    m_MappingHandle = mapping;
+    m_Data = static_cast<const char*>(view);
+    m_Size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+#else
+bool PageSource::mapFile(const std::string& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // Hints only, the mapping works without them
+    madvise(mapping, size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+    madvise(mapping, size, MADV_HUGEPAGE);
+#endif
+    m_Mapping = mapping;
+    m_Data = static_cast<const char*>(mapping);
+    m_Size = size;
+    return true;
+}
+#endif
+
+bool PageSource::readFile(const std::string& path)
+{
+    std::ifstream inputFile(path, std::ios::in | std::ios::binary);
+    if (!inputFile)
+    {
+        return false;
+    }
+    m_Buffer.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+    return true;
+}
+
+void PageSource::release()
+{
+    if (m_Mapping != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_Mapping);
+        CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+#else
+        munmap(m_Mapping, m_Size);
+#endif
+    }
+    m_Mapping = nullptr;
+    m_MappingHandle = nullptr;
+    m_Buffer.clear();
+    m_Data = nullptr;
+    m_Size = 0;
+}
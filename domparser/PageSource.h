@@ -0,0 +1,39 @@
+#ifndef DOMPARSER_PAGESOURCE_H
+#define DOMPARSER_PAGESOURCE_H
+
+#include <cstddef>
+#include <string>
+
+// Input document the parser reads in place. Files are memory-mapped (with
+// sequential read-ahead and huge pages where the system offers them), so
+// nothing is copied; a string source owns its own copy.
+class PageSource
+{
+public:
+    PageSource() = default;
+    explicit PageSource(const std::string&);
+    ~PageSource();
+
+    PageSource(const PageSource&) = delete;
+    PageSource& operator=(const PageSource&) = delete;
+
+    bool open(const std::string&);
+    const char* getData() const;
+    size_t getSize() const;
+    bool empty() const;
+    bool isMapped() const;
+
+private:
+    bool mapFile(const std::string&);
+    bool readFile(const std::string&);
+    void release();
+
+private:
+    const char* m_Data = nullptr;
+    size_t m_Size = 0;
+    void* m_Mapping = nullptr;
+    void* m_MappingHandle = nullptr;
+    std::string m_Buffer {};
+};
+
+#endif //DOMPARSER_PAGESOURCE_H
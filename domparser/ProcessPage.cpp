@@ -1,18 +1,95 @@
 #include "ProcessPage.h"
 #include "ContentParser.h"
-#include "AttributeParser.h"
-#include "AttributeValueParser.h"
 #include "TagNameParser.h"
+#include "Tokenizer.h"
+#include "TreeBuilder.h"
+#include "SaxParser.h"
+#include "SelectorCache.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 
+namespace
+{
+    // Checks the tags as the tree is built and ends the build once the limits are reached.
+    // A rule that needs what follows a tag is left to be checked after the build.
+    class LimitedQuery : public TreeBuilder::Observer
+    {
+    public:
+        LimitedQuery(Document& document, const CheckRulesFactory& rule, size_t offset, size_t needed, const CheckRulesFactory* stopAfter)
+        : m_Document(document),
+          m_Rule(rule),
+          m_Offset(offset),
+          m_Needed(needed),
+          m_StopAfter(stopAfter),
+          m_CheckOnStart(!rule.needsFollowingContent())
+        {}
+
+        virtual bool elementStarted(uint32_t index)
+        {
+            if (m_CheckOnStart && m_Matches.size() < m_Needed && m_Rule.checkRules(&m_Document.getNode(index)))
+            {
+                m_Matches.push_back(index);
+                // Kept tags are only complete once they close
+                m_OpenResults += m_Matches.size() > m_Offset ? 1 : 0;
+            }
+            return !isDone();
+        }
+
+        virtual bool elementClosed(uint32_t index)
+        {
+            if (m_Matches.size() > m_Offset && std::binary_search(m_Matches.begin() + m_Offset, m_Matches.end(), index))
+            {
+                --m_OpenResults;
+            }
+
+            if (m_StopAfter != nullptr && m_StopAfter->checkRules(&m_Document.getNode(index)))
+            {
+                return false;
+            }
+            return !isDone();
+        }
+
+        bool isCheckedOnStart() const
+        {
+            return m_CheckOnStart;
+        }
+
+        std::vector<uint32_t>& getMatches()
+        {
+            return m_Matches;
+        }
+
+    private:
+        bool isDone() const
+        {
+            return m_CheckOnStart && m_Matches.size() >= m_Needed && m_OpenResults == 0;
+        }
+
+    private:
+        Document& m_Document;
+        const CheckRulesFactory& m_Rule;
+        size_t m_Offset;
+        size_t m_Needed;
+        const CheckRulesFactory* m_StopAfter;
+        bool m_CheckOnStart;
+        std::vector<uint32_t> m_Matches {};
+        size_t m_OpenResults = 0;
+    };
+}
+
 ProcessPage::ProcessPage(const std::string& pathToPage, const std::string& rule)
-: m_CheckRulePtr(CheckRulesFactory::createCheckRulesFactory(rule))
+: m_CheckRulePtr(SelectorCache::getGlobal().get(rule))
 {
     processInputPageHelper(pathToPage);
 }
 
+ProcessPage::~ProcessPage()
+{
+
+}
+
 void ProcessPage::setWebPage(const std::string& pathToPage)
 {
     processInputPageHelper(pathToPage);
@@ -20,13 +97,19 @@ void ProcessPage::setWebPage(const std::string& pathToPage)
 
 void ProcessPage::setSourceWebPage(const std::string& dataPage)
 {
-    m_InputPage = dataPage;
+    m_Source = std::make_shared<PageSource>(dataPage);
 }
 
 void ProcessPage::processInputPageHelper(const std::string& pathToPage)
 {
-    std::ifstream inputFile(pathToPage, std::ios::in);
-    m_InputPage.insert(m_InputPage.begin(), std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+    auto source = std::make_shared<PageSource>();
+    source->open(pathToPage);
+    m_Source = std::move(source);
+}
+
+std::shared_ptr<const PageSource> ProcessPage::getSource() const
+{
+    return m_Source;
 }
 
 std::vector<Tag> ProcessPage::getPageData() const
@@ -34,55 +117,394 @@ std::vector<Tag> ProcessPage::getPageData() const
     return m_PageData;
 }
 
+Document& ProcessPage::getDocument()
+{
+    return m_Page->document;
+}
+
+std::shared_ptr<const void> ProcessPage::getDocumentOwner() const
+{
+    return m_Page;
+}
+
+void ProcessPage::setIndexing(bool indexing)
+{
+    m_Indexing = indexing;
+    m_Page->document.setIndexed(indexing);
+}
+
+void ProcessPage::setLazyAttributes(bool lazy)
+{
+    m_LazyAttributes = lazy;
+}
+
+void ProcessPage::setSelectiveBuild(bool selective)
+{
+    m_SelectiveBuild = selective;
+}
+
+void ProcessPage::setParserEngine(ParserEngine engine)
+{
+    m_ParserEngine = engine;
+}
+
+ParserEngine ProcessPage::getParserEngine() const
+{
+    return m_ParserEngine;
+}
+
 void ProcessPage::process()
 {
     if (m_CheckRulePtr == nullptr)
     {
         throw std::logic_error("Rule is incorrect");
     }
-    processHelper(m_InputPage, m_PageData, nullptr);
+    clearTagsHelper();
+    parseHelper(m_SelectiveBuild ? m_CheckRulePtr.get() : nullptr);
+    selectPageDataHelper();
+}
+
+void ProcessPage::process(const QueryLimits& limits)
+{
+    std::shared_ptr<const CheckRulesFactory> stopAfter;
+
+    if (!limits.stopAfter.empty())
+    {
+        stopAfter = SelectorCache::getGlobal().get(limits.stopAfter);
+    }
+
+    if (m_CheckRulePtr == nullptr || (!limits.stopAfter.empty() && stopAfter == nullptr))
+    {
+        throw std::logic_error("Rule is incorrect");
+    }
+    clearTagsHelper();
+    const size_t needed = limits.limit > SIZE_MAX - limits.offset ? SIZE_MAX : limits.offset + limits.limit;
+    std::vector<uint32_t> indices;
+
+    if (m_ParserEngine == ParserEngine::Tokenizer && (needed != SIZE_MAX || stopAfter != nullptr))
+    {
+        LimitedQuery query(m_Page->document, *m_CheckRulePtr, limits.offset, needed, stopAfter.get());
+        TreeBuilder builder(m_Page->document, &query);
+        builder.setLazyAttributes(m_LazyAttributes);
+        builder.setRegions(m_SelectiveBuild && stopAfter == nullptr ? m_CheckRulePtr.get() : nullptr);
+        builder.build(m_Source->getData(), m_Source->getSize());
+        indices.swap(query.getMatches());
+
+        if (!query.isCheckedOnStart())
+        {
+            m_CheckRulePtr->selectNodes(m_Page->document, indices, needed);
+        }
+    }
+    else
+    {
+        // The tags of the stop rule may lie outside of the regions
+        parseHelper(m_SelectiveBuild && stopAfter == nullptr ? m_CheckRulePtr.get() : nullptr);
+        m_CheckRulePtr->selectNodes(m_Page->document, indices, needed);
+
+        // The whole page was parsed, the tags that start after the end are dropped
+        if (stopAfter != nullptr)
+        {
+            const uint32_t bound = stopBoundHelper(*stopAfter);
+            indices.erase(std::lower_bound(indices.begin(), indices.end(), bound), indices.end());
+        }
+    }
+
+    for (size_t i = limits.offset; i < indices.size(); ++i)
+    {
+        m_PageData.emplace_back(copyHelper(indices[i]));
+    }
+}
+
+void ProcessPage::process(ISaxHandler& handler)
+{
+    if (m_CheckRulePtr == nullptr)
+    {
+        throw std::logic_error("Rule is incorrect");
+    }
+
+    if (m_CheckRulePtr->needsDocument())
+    {
+        throw std::logic_error("Rule needs the document tree");
+    }
+    SaxParser(handler, *m_CheckRulePtr).parse(m_Source->getData(), m_Source->getSize());
 }
 
-void ProcessPage::processHelper(const std::string& input, std::vector<Tag>& pageData, Tag* tagPtr)
+std::vector<std::vector<Tag>> ProcessPage::process(const SelectorSet& selectors)
 {
-    if (!input.empty())
+    clearTagsHelper();
+    parseHelper(nullptr);
+    std::vector<std::vector<Tag>> result;
+    result.reserve(selectors.getSize());
+
+    for (const auto& indices : selectors.select(m_Page->document))
     {
-        auto tempVec = ContentParser(input).parse();
+        result.emplace_back();
+        result.back().reserve(indices.size());
 
-        for (const auto& i : tempVec)
+        for (const auto i : indices)
         {
-            Tag* tag = new Tag;
-            tag->setTagName(i.getTagName());
-            tag->setContent(i.getContent());
-            auto attributes = AttributeParser(i.getNotParsingAttributes()).parse();
+            result.back().push_back(copyHelper(i));
+        }
+    }
+    return result;
+}
 
-            for (const auto& attributesIter : attributes)
+uint32_t ProcessPage::stopBoundHelper(const CheckRulesFactory& stopAfter)
+{
+    // The first matching element to close is the innermost one of the first that matches
+    std::vector<uint32_t> matches;
+    stopAfter.selectNodes(m_Page->document, matches, SIZE_MAX);
+    uint32_t bound = m_Page->document.getSize();
+
+    for (const auto i : matches)
+    {
+        if (i >= bound)
+        {
+            break;
+        }
+        bound = m_Page->document.getNode(i).getSubtreeEnd();
+    }
+    return bound;
+}
+
+void ProcessPage::parseHelper(const CheckRulesFactory* regions)
+{
+    if (m_ParserEngine == ParserEngine::Regex)
+    {
+        processHelper(StringSpan(m_Source->getData(), m_Source->getSize()), regions);
+        return;
+    }
+    TreeBuilder builder(m_Page->document);
+    builder.setLazyAttributes(m_LazyAttributes);
+    builder.setRegions(regions);
+    builder.build(m_Source->getData(), m_Source->getSize());
+}
+
+void ProcessPage::processHelper(const StringSpan& input, const CheckRulesFactory* regions)
+{
+    // Only the positions are kept, the copies of the parser are gone before going deeper
+    struct Element
+    {
+        StringSpan tagName;
+        StringSpan attributes;
+        StringSpan content;
+        StringSpan outerHtml;
+    };
+
+    // The elements found in the content of a parent, and the next one to add
+    struct Level
+    {
+        uint32_t parent;
+        std::vector<Element> elements;
+        size_t next;
+    };
+
+    // The stack replaces the recursion, its levels and the buffers are reused at every depth
+    std::vector<Level> stack;
+    size_t depth = 0;
+    ContentParser contentParser("");
+    std::vector<Tokenizer::Attribute> attributes;
+    Tag regionTag;
+
+    if (regions != nullptr && !regions->hasRegions())
+    {
+        regions = nullptr;
+    }
+
+    auto pushLevel = [&](const StringSpan content, uint32_t parent)
+    {
+        if (depth == stack.size())
+        {
+            stack.emplace_back();
+        }
+        Level& level = stack[depth++];
+        level.parent = parent;
+        level.elements.clear();
+        level.next = 0;
+
+        if (!content.empty())
+        {
+            contentParser.setData(content.str());
+
+            for (const auto& i : contentParser.parse())
             {
-                tag->setAttributeTag(attributesIter.getAttribute());
+                // "<name attributes>"
+                const char* begin = content.data() + i.getOffset();
+                const size_t nameSize = i.getTagName().size();
+                level.elements.push_back({StringSpan(begin + 1, nameSize),
+                                          StringSpan(begin + 1 + nameSize, i.getNotParsingAttributes().size()),
+                                          StringSpan(content.data() + i.getContentOffset(), i.getContent().size()),
+                                          StringSpan(begin, i.getLength())});
             }
-            auto attributesValue = AttibuteValueParser(i.getNotParsingAttributes()).parse();
+        }
+    };
+
+    // Whether anything but the children and comments lies between the start and the end tag
+    auto hasTextHelper = [](const Element& element, const std::vector<Element>& children)
+    {
+        const char* position = element.attributes.data() + element.attributes.size() + 1;
+        const char* end = element.outerHtml.data() + element.outerHtml.size() - element.tagName.size() - 3;
+        size_t child = 0;
 
-            for (const auto& attributesValueIter : attributesValue)
+        while (position < end)
+        {
+            if (child < children.size() && children[child].outerHtml.data() == position)
+            {
+                position += children[child++].outerHtml.size();
+            }
+            else if (StringSpan(position, end - position).startsWith("<!--"))
+            {
+                const char* comment = std::search(position + 4, end, "-->", "-->" + 3);
+                position = comment == end ? end : comment + 3;
+            }
+            else
             {
-                tag->setAttributeValueTag(attributesValueIter.getAttributeValue());
+                return true;
             }
+        }
+        return false;
+    };
+
+    pushLevel(input, Document::npos);
+
+    while (depth > 0)
+    {
+        Level& level = stack[depth - 1];
 
-            tag->setParent(tagPtr);
-            
-            if (tagPtr != nullptr && !pageData.empty())
+        if (level.next == level.elements.size())
+        {
+            if (level.parent != Document::npos)
             {
-                auto position = std::find(pageData.begin(), pageData.end(), tagPtr);
-                if (position != pageData.end())
-                {
-                    position->setChildren(tag);
-                }
+                m_Page->document.close(level.parent);
             }
+            --depth;
+            continue;
+        }
+        const Element& element = level.elements[level.next++];
 
-            if (m_CheckRulePtr->checkRules(tag))
+        if (regions != nullptr && level.parent == Document::npos)
+        {
+            regionTag.setTagNameView(element.tagName);
+            regionTag.clearAttributes();
+            regionTag.setUnparsedAttributesView(element.attributes);
+
+            if (!regions->isRegionRoot(regionTag))
             {
-                pageData.emplace_back(*tag);
+                // Left out, the regions are looked for in its content
+                pushLevel(element.content, Document::npos);
+                continue;
             }
-            processHelper(i.getContent(), pageData, tag);
         }
+        const uint32_t index = m_Page->document.append(level.parent);
+        Tag* tag = &m_Page->document.getNode(index);
+        tag->setTagNameView(element.tagName);
+        tag->setContentView(element.content);
+        tag->setOuterHtmlView(element.outerHtml);
+
+        if (m_LazyAttributes)
+        {
+            tag->setUnparsedAttributesView(element.attributes);
+        }
+        else
+        {
+            // Names and values are lexed together, so they stay paired as with the tokenizer
+            Tokenizer::lexAttributes(element.attributes.data(), element.attributes.size(), attributes);
+
+            for (const auto& i : attributes)
+            {
+                tag->setAttributeView(StringSpan(element.attributes.data() + i.nameBegin, i.nameEnd - i.nameBegin),
+                                      StringSpan(element.attributes.data() + i.valueBegin, i.valueEnd - i.valueBegin));
+            }
+        }
+        m_Page->document.indexNode(index);
+        // The level may move when the stack grows
+        pushLevel(element.content, index);
+        tag->setHasText(hasTextHelper(element, stack[depth - 1].elements));
+    }
+}
+
+void ProcessPage::beginFeed(ISaxHandler* handler)
+{
+    if (m_CheckRulePtr == nullptr)
+    {
+        throw std::logic_error("Rule is incorrect");
+    }
+
+    if (handler != nullptr && m_CheckRulePtr->needsDocument())
+    {
+        throw std::logic_error("Rule needs the document tree");
+    }
+    clearTagsHelper();
+    m_PushBuildsTags = handler == nullptr;
+
+    if (m_PushBuildsTags)
+    {
+        m_PushParser.reset(new PushParser(m_Page->document));
+    }
+    else
+    {
+        m_PushParser.reset(new PushParser(*handler, *m_CheckRulePtr));
+    }
+}
+
+void ProcessPage::feed(const char* data, size_t size)
+{
+    if (m_PushParser == nullptr)
+    {
+        beginFeed();
     }
-}
\ No newline at end of file
+    m_PushParser->feed(data, size);
+}
+
+void ProcessPage::finish()
+{
+    if (m_PushParser == nullptr)
+    {
+        beginFeed();
+    }
+    m_PushParser->finish();
+    m_PushParser.reset();
+
+    if (m_PushBuildsTags)
+    {
+        selectPageDataHelper();
+    }
+}
+
+void ProcessPage::selectPageDataHelper()
+{
+    std::vector<uint32_t> indices;
+    m_CheckRulePtr->selectNodes(m_Page->document, indices, SIZE_MAX);
+    m_PageData.reserve(indices.size());
+
+    for (const auto i : indices)
+    {
+        m_PageData.emplace_back(copyHelper(i));
+    }
+}
+
+Tag ProcessPage::copyHelper(uint32_t index) const
+{
+    Tag copy(m_Page->document.getNode(index));
+    copy.setOwner(m_Page);
+    return copy;
+}
+
+void ProcessPage::clearTagsHelper()
+{
+    // Drops the references the stored copies hold, only those handed out remain
+    m_PageData.clear();
+
+    if (m_Page.use_count() > 1)
+    {
+        // Copies of the tags still refer to the page, the next one is parsed into a new document
+        m_Page = std::make_shared<ParsedPage>();
+        m_Page->document.setIndexed(m_Indexing);
+    }
+    else
+    {
+        m_Page->document.clear();
+        m_Page->arena.reset();
+    }
+    m_Page->source = m_Source;
+}
@@ -1,33 +1,111 @@
 #ifndef DOMPARSER_PROCESSPAGE_H
 #define DOMPARSER_PROCESSPAGE_H
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
 
+#include "Arena.h"
 #include "BaseParser.h"
 #include "Tag.h"
 #include "CheckRulesFactory.h"
+#include "Document.h"
+#include "ISaxHandler.h"
+#include "PageSource.h"
+#include "PushParser.h"
+#include "SelectorSet.h"
+
+enum class ParserEngine
+{
+    Regex,      // Nested ContentParser passes, kept for comparison
+    Tokenizer   // Single forward pass, linear in the input size
+};
+
+// Bounds of a query. With the tokenizer engine the page is only read until they are reached.
+struct QueryLimits
+{
+    size_t offset = 0;          // Matching tags skipped before the first one kept
+    size_t limit = SIZE_MAX;    // Matching tags kept at most
+    // Rule of the element whose end tag ends the page, the first matching element to close.
+    // Elements still open there end at that point.
+    std::string stopAfter {};
+};
 
 class ProcessPage
 {
 public:
     ProcessPage(const std::string&, const std::string& = "*");
-    ~ProcessPage() = default;
+    ~ProcessPage();
 
     void setWebPage(const std::string&);
     void setSourceWebPage(const std::string&);
+    void setParserEngine(ParserEngine);
+    ParserEngine getParserEngine() const;
+    // Fills the lookup tables of the document while parsing, off by default
+    void setIndexing(bool);
+    // Attributes are lexed only for the tags whose attributes are read, off by default.
+    // Queries that test only tag names then skip most of the attribute work. The tags are then
+    // written to by their first attribute read, even a const one: not safe from several threads.
+    void setLazyAttributes(bool);
+    // When the rule can only match inside the subtrees of some tags ("table > tr", "ul li"), only
+    // those subtrees are built, off by default. getDocument() then holds just those tags and the
+    // top tag of each subtree has no parent. The other queries build the whole page.
+    void setSelectiveBuild(bool);
     void process();
+    // Keeps only the matching tags within the limits, the rule of stopAfter must be correct
+    void process(const QueryLimits&);
+    // Streaming mode: events go to the handler and no tags are stored. Rules that read
+    // siblings or content are rejected, see ISaxHandler.
+    void process(ISaxHandler&);
+    // Parses the page once for all the rules of the set, the tags of every rule in
+    // the order of the set. The tags refer to this object like those of getPageData().
+    std::vector<std::vector<Tag>> process(const SelectorSet&);
+    // Push mode: hand over the document in chunks, then call finish().
+    // With a handler events are streamed as elements close, otherwise
+    // getPageData() is available after finish().
+    void beginFeed(ISaxHandler* = nullptr);
+    void feed(const char*, size_t);
+    void finish();
+    // Copies of the matching tags. They refer to the page source and the document, which the
+    // copies keep alive: they stay valid after this object is gone or has parsed another page.
     std::vector<Tag> getPageData() const;
+    std::shared_ptr<const PageSource> getSource() const;
+    // Every tag of the last parsed page, matching or not
+    Document& getDocument();
+    // Owner of the source, the arena and the document of the last parsed page
+    std::shared_ptr<const void> getDocumentOwner() const;
 
 private:
     void processInputPageHelper(const std::string&);
-    void processHelper(const std::string&, std::vector<Tag>&, Tag*);
+    // The rule gives the regions to build, nullptr builds the whole page
+    void processHelper(const StringSpan&, const CheckRulesFactory*);
+    void parseHelper(const CheckRulesFactory*);
+    uint32_t stopBoundHelper(const CheckRulesFactory&);
+    void selectPageDataHelper();
+    Tag copyHelper(uint32_t) const;
+    void clearTagsHelper();
 
 private:
-    std::string m_InputPage {};
+    // What the tags of a parsed page refer to. The copies of the tags hold it, so the next page
+    // gets a new one while copies are alive and reuses this one, arena included, otherwise.
+    struct ParsedPage
+    {
+        std::shared_ptr<PageSource> source {};
+        Arena arena {};
+        Document document {arena}; // Every tag of the document in document order
+    };
+
+    std::shared_ptr<PageSource> m_Source {};
+    std::shared_ptr<ParsedPage> m_Page {std::make_shared<ParsedPage>()};
     std::vector<Tag> m_PageData {};
-    std::unique_ptr<CheckRulesFactory> m_CheckRulePtr;
+    bool m_Indexing = false;
+    ParserEngine m_ParserEngine = ParserEngine::Tokenizer;
+    bool m_LazyAttributes = false;
+    bool m_SelectiveBuild = false;
+    std::unique_ptr<PushParser> m_PushParser {};
+    bool m_PushBuildsTags = false;
+    std::shared_ptr<const CheckRulesFactory> m_CheckRulePtr;
 };
 
 
@@ -0,0 +1,82 @@
+#include "PushParser.h"
+
+PushParser::PushParser(Document& document)
+: m_Tokenizer(nullptr, 0),
+  m_TreeBuilder(new TreeBuilder(document))
+{
+
+}
+
+PushParser::PushParser(ISaxHandler& handler, const CheckRulesFactory& checkRule)
+: m_Tokenizer(nullptr, 0),
+  m_SaxParser(new SaxParser(handler, checkRule))
+{
+
+}
+
+void PushParser::feed(const char* data, size_t size)
+{
+    m_Buffer.append(data, size);
+    parseAvailable(false);
+}
+
+void PushParser::finish()
+{
+    parseAvailable(true);
+
+    if (m_TreeBuilder != nullptr)
+    {
+        m_TreeBuilder->finish(m_Offset + m_Buffer.size());
+    }
+    else
+    {
+        m_SaxParser->finish();
+    }
+    m_Buffer.clear();
+}
+
+size_t PushParser::getBufferSize() const
+{
+    return m_Buffer.size();
+}
+
+void PushParser::parseAvailable(bool final)
+{
+    m_Tokenizer.setInput(m_Buffer.data(), m_Buffer.size(), final);
+    if (m_TreeBuilder != nullptr)
+    {
+        m_TreeBuilder->setInput(m_Buffer.data(), m_Offset);
+    }
+
+    while (m_Tokenizer.next(m_Token))
+    {
+        if (m_TreeBuilder != nullptr)
+        {
+            m_TreeBuilder->handleToken(m_Token);
+        }
+        else
+        {
+            m_SaxParser->handleToken(m_Buffer.data(), m_Token);
+        }
+    }
+
+    if (final)
+    {
+        return;
+    }
+
+    // The tree builder copies what it needs of the bytes before
+    const size_t retain = m_Tokenizer.getRetainOffset();
+
+    // Compact only when at least half of the buffer is dead, which keeps copying linear
+    if (retain != 0 && retain * 2 >= m_Buffer.size())
+    {
+        if (m_TreeBuilder != nullptr)
+        {
+            m_TreeBuilder->release(m_Offset + retain);
+        }
+        m_Buffer.erase(0, retain);
+        m_Tokenizer.discard(retain);
+        m_Offset += retain;
+    }
+}
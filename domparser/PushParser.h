@@ -0,0 +1,42 @@
+#ifndef DOMPARSER_PUSHPARSER_H
+#define DOMPARSER_PUSHPARSER_H
+
+#include <memory>
+#include <string>
+
+#include "CheckRulesFactory.h"
+#include "Document.h"
+#include "ISaxHandler.h"
+#include "SaxParser.h"
+#include "Tag.h"
+#include "Tokenizer.h"
+#include "TreeBuilder.h"
+
+// Accepts the document in chunks of any size and parses each chunk as it
+// arrives. The tokenizer state survives chunk boundaries, even in the middle
+// of a tag or an attribute; only the bytes still referenced are kept.
+class PushParser
+{
+public:
+    explicit PushParser(Document&);                         // Builds the tree
+    PushParser(ISaxHandler&, const CheckRulesFactory&);     // Streams events
+    ~PushParser() = default;
+
+    void feed(const char*, size_t);
+    void finish();
+    // Bytes of the input kept, from the start of the token being read
+    size_t getBufferSize() const;
+
+private:
+    void parseAvailable(bool);
+
+private:
+    std::string m_Buffer {};
+    size_t m_Offset = 0; // Document offset of the first byte in m_Buffer
+    Tokenizer m_Tokenizer;
+    Tokenizer::Token m_Token {};
+    std::unique_ptr<TreeBuilder> m_TreeBuilder;
+    std::unique_ptr<SaxParser> m_SaxParser;
+};
+
+#endif //DOMPARSER_PUSHPARSER_H
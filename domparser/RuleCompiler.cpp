@@ -0,0 +1,228 @@
+#include "RuleCompiler.h"
+#include "CssSelectorCompiler.h"
+#include "SelectAllRule.h"
+#include "SelectDivRule.h"
+#include "SelectAllWithAttribute.h"
+#include "SelectAllWithAttributeAndValue.h"
+#include "SelectAllWithEndString.h"
+#include "SelectAllNotEqualAttributeValue.h"
+#include "SelectAllWithBeginString.h"
+#include "SelectAllWithPartString.h"
+#include "SelectTagsWithMatchingAttributes.h"
+#include "SelectSpecificTagWithSpecifiedAttribute.h"
+#include "SelectChildrenTagWithAttribute.h"
+#include "SelectChildrenOfTheSpecificTag.h"
+
+#include <cctype>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    bool isWord(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+    }
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+}
+
+RuleCompiler::RuleCompiler(const std::string& rule)
+: m_Rule(rule)
+{
+
+}
+
+size_t RuleCompiler::scanWord(size_t position) const
+{
+    while (position < m_Rule.size() && isWord(m_Rule[position]))
+    {
+        ++position;
+    }
+    return position;
+}
+
+size_t RuleCompiler::scanValue(size_t position, ValueKind kind) const
+{
+    if (kind == ValueKind::DotWord)
+    {
+        return position < m_Rule.size() && m_Rule[position] == '.' ? scanWord(position + 1) : position;
+    }
+
+    while (position < m_Rule.size())
+    {
+        const char c = m_Rule[position];
+        if (!isWord(c) && !(kind != ValueKind::Word && c == '.') && !(kind == ValueKind::WordDotOrPlus && c == '+'))
+        {
+            break;
+        }
+        ++position;
+    }
+    return position;
+}
+
+size_t RuleCompiler::skipSpaces(size_t position) const
+{
+    while (position < m_Rule.size() && isSpace(m_Rule[position]))
+    {
+        ++position;
+    }
+    return position;
+}
+
+bool RuleCompiler::matchAttribute(size_t position, const char* op, char quote, ValueKind kind, AttributeMatch& match) const
+{
+    if (position >= m_Rule.size() || m_Rule[position] != '[')
+    {
+        return false;
+    }
+    const size_t nameBegin = position + 1;
+    const size_t nameEnd = scanWord(nameBegin);
+
+    if (nameEnd == nameBegin)
+    {
+        return false;
+    }
+    position = nameEnd;
+
+    const size_t opSize = std::strlen(op);
+    if (opSize != 0)
+    {
+        if (m_Rule.compare(position, opSize, op) != 0 || position + opSize >= m_Rule.size() || m_Rule[position + opSize] != quote)
+        {
+            return false;
+        }
+        const size_t valueBegin = position + opSize + 1;
+        const size_t valueEnd = scanValue(valueBegin, kind);
+
+        if (valueEnd == valueBegin || (kind == ValueKind::DotWord && valueEnd == valueBegin + 1) ||
+            valueEnd >= m_Rule.size() || m_Rule[valueEnd] != quote)
+        {
+            return false;
+        }
+        match.value.assign(m_Rule, valueBegin, valueEnd - valueBegin);
+        position = valueEnd + 1;
+    }
+
+    if (position >= m_Rule.size() || m_Rule[position] != ']')
+    {
+        return false;
+    }
+    match.name.assign(m_Rule, nameBegin, nameEnd - nameBegin);
+    match.end = position + 1;
+    return true;
+}
+
+bool RuleCompiler::matchRule(const char* op, char quote, ValueKind kind, AttributeMatch& match) const
+{
+    return matchAttribute(0, op, quote, kind, match) && match.end == m_Rule.size();
+}
+
+bool RuleCompiler::matchAttributeList(std::vector<std::pair<std::string, std::string>>& attributes) const
+{
+    AttributeMatch match;
+
+    for (size_t i = 0; i < m_Rule.size();)
+    {
+        if (!matchAttribute(i, "=", '"', ValueKind::WordOrDot, match))
+        {
+            return false;
+        }
+        attributes.emplace_back(match.name, match.value);
+        i = skipSpaces(match.end);
+
+        if (i < m_Rule.size() && m_Rule[i] == ',')
+        {
+            i = skipSpaces(i + 1);
+        }
+    }
+    return !attributes.empty();
+}
+
+CheckRulesFactory* RuleCompiler::compile() const
+{
+    if (m_Rule == "*")
+    {
+        return new SelectAllRule();
+    }
+
+    if (m_Rule == "div")
+    {
+        return new SelectDivRule(m_Rule);
+    }
+    AttributeMatch match;
+
+    if (matchRule("", '\0', ValueKind::Word, match))
+    {
+        return new SelectAllWithAttribute(match.name);
+    }
+
+    if (matchRule("=", '\'', ValueKind::Word, match))
+    {
+        return new SelectAllWithAttributeAndValue(match.name, match.value);
+    }
+
+    if (matchRule("$=", '\'', ValueKind::DotWord, match))
+    {
+        return new SelectAllWithEndString(match.name, match.value);
+    }
+
+    if (matchRule("!=", '\'', ValueKind::WordDotOrPlus, match))
+    {
+        return new SelectAllNotEqualAttributeValue(match.name, match.value);
+    }
+
+    if (matchRule("^=", '\'', ValueKind::WordOrDot, match))
+    {
+        return new SelectAllWithBeginString(match.name, match.value);
+    }
+
+    if (matchRule("*=", '\'', ValueKind::WordOrDot, match))
+    {
+        return new SelectAllWithPartString(match.name, match.value);
+    }
+    std::vector<std::pair<std::string, std::string>> attributes;
+
+    // Unlike a CSS selector list, every attribute of the list has to match
+    if (matchAttributeList(attributes))
+    {
+        return new SelectTagsWithMatchingAttributes(attributes);
+    }
+    const size_t nameEnd = scanWord(0);
+
+    if (nameEnd != 0)
+    {
+        const std::string name = m_Rule.substr(0, nameEnd);
+
+        if (matchAttribute(nameEnd, "=", '"', ValueKind::WordOrDot, match))
+        {
+            if (match.end == m_Rule.size())
+            {
+                return new SelectSpecificTagWithSpecifiedAttribute(name, match.name, match.value);
+            }
+            AttributeMatch childMatch;
+
+            if (matchAttribute(match.end, "=", '"', ValueKind::WordOrDot, childMatch) && childMatch.end == m_Rule.size())
+            {
+                return new SelectChildrenTagWithAttribute(name, match.name, match.value, childMatch.name, childMatch.value);
+            }
+        }
+        const size_t combinator = skipSpaces(nameEnd);
+
+        if (combinator < m_Rule.size() && m_Rule[combinator] == '>')
+        {
+            const size_t childBegin = skipSpaces(combinator + 1);
+            const size_t childEnd = scanWord(childBegin);
+
+            if (childEnd != childBegin && childEnd == m_Rule.size())
+            {
+                return new SelectChildrenOfTheSpecificTag(name, m_Rule.substr(childBegin, childEnd - childBegin));
+            }
+        }
+    }
+    return CssSelectorCompiler(m_Rule).compile();
+}
@@ -0,0 +1,53 @@
+#ifndef DOMPARSER_RULECOMPILER_H
+#define DOMPARSER_RULECOMPILER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CheckRulesFactory.h"
+
+// Recognizes the rule shapes by scanning the rule text once and builds the
+// matching rule object. A rule that is exactly one of the original shapes
+// keeps its original meaning, e.g. div[id="a"][class="b"] selects the
+// children of div[id="a"]. Any other rule is compiled as a CSS selector list.
+class RuleCompiler
+{
+public:
+    explicit RuleCompiler(const std::string&);
+    ~RuleCompiler() = default;
+
+    // Returns nullptr if the rule is incorrect
+    CheckRulesFactory* compile() const;
+
+private:
+    enum class ValueKind
+    {
+        Word,           // [\w]+
+        WordOrDot,      // [\w.]+
+        WordDotOrPlus,  // [\w.+]+
+        DotWord         // \.[\w]+
+    };
+
+    struct AttributeMatch
+    {
+        size_t end = 0;
+        std::string name {};
+        std::string value {};
+    };
+
+    // "[name]" when the operator is empty, otherwise "[name<operator><quote>value<quote>]"
+    bool matchAttribute(size_t, const char*, char, ValueKind, AttributeMatch&) const;
+    // The whole rule is a single attribute of the shape
+    bool matchRule(const char*, char, ValueKind, AttributeMatch&) const;
+    // [a="b"][c="d"] or [a="b"],[c="d"] and so on
+    bool matchAttributeList(std::vector<std::pair<std::string, std::string>>&) const;
+    size_t scanWord(size_t) const;
+    size_t scanValue(size_t, ValueKind) const;
+    size_t skipSpaces(size_t) const;
+
+private:
+    std::string m_Rule;
+};
+
+#endif //DOMPARSER_RULECOMPILER_H
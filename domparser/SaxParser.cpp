@@ -0,0 +1,138 @@
+#include "SaxParser.h"
+
+SaxParser::SaxParser(ISaxHandler& handler, const CheckRulesFactory& checkRule)
+: m_Handler(handler),
+  m_CheckRule(checkRule)
+{
+
+}
+
+void SaxParser::parse(const char* data, size_t size)
+{
+    Tokenizer tokenizer(data, size);
+    Tokenizer::Token token;
+
+    while (tokenizer.next(token))
+    {
+        handleToken(data, token);
+    }
+    finish();
+}
+
+void SaxParser::handleToken(const char* data, const Tokenizer::Token& token)
+{
+    switch (token.type)
+    {
+        case Tokenizer::TokenType::StartTag:
+            startElement(data, token);
+            break;
+        case Tokenizer::TokenType::EndTag:
+            endElement(data, token);
+            break;
+        case Tokenizer::TokenType::Text:
+        case Tokenizer::TokenType::Comment:
+            if (m_OpenMatches != 0)
+            {
+                m_Text.assign(data + token.nameBegin, token.nameEnd - token.nameBegin);
+                if (token.type == Tokenizer::TokenType::Text)
+                {
+                    m_Handler.text(m_Text);
+                }
+                else
+                {
+                    m_Handler.comment(m_Text);
+                }
+            }
+            break;
+    }
+}
+
+void SaxParser::finish()
+{
+    while (m_Depth != 0)
+    {
+        closeElement();
+    }
+}
+
+void SaxParser::startElement(const char* data, const Tokenizer::Token& token)
+{
+    if (m_Elements.size() == m_Depth)
+    {
+        m_Elements.emplace_back();
+        m_Names.emplace_back();
+        m_Matched.emplace_back(false);
+    }
+    Tag& tag = m_Elements[m_Depth];
+    std::string& name = m_Names[m_Depth];
+
+    name.assign(data + token.nameBegin, token.nameEnd - token.nameBegin);
+    tag.setTagName(name);
+    tag.setParent(m_Depth == 0 ? nullptr : &m_Elements[m_Depth - 1]);
+    tag.clearAttributes();
+
+    for (const auto& i : token.attributes)
+    {
+        tag.setAttributeTag(std::string(data + i.nameBegin, i.nameEnd - i.nameBegin));
+        tag.setAttributeValueTag(std::string(data + i.valueBegin, i.valueEnd - i.valueBegin));
+    }
+
+    const bool matched = m_CheckRule.checkRules(&tag);
+    m_Matched[m_Depth] = matched;
+    m_OpenNames.add(name);
+    ++m_Depth;
+
+    if (matched)
+    {
+        ++m_OpenMatches;
+        m_Attributes.resize(token.attributes.size());
+
+        for (size_t i = 0; i < m_Attributes.size(); ++i)
+        {
+            const StringSpan attribute = tag.getAttributeName(i);
+            const StringSpan attributeValue = tag.getAttributeValue(i);
+            m_Attributes[i].first.assign(attribute.data(), attribute.size());
+            m_Attributes[i].second.assign(attributeValue.data(), attributeValue.size());
+        }
+        m_Handler.startElement(name, m_Attributes);
+    }
+
+    if (token.selfClosing || Tokenizer::isVoidElement(data + token.nameBegin, token.nameEnd - token.nameBegin))
+    {
+        closeElement();
+    }
+}
+
+void SaxParser::endElement(const char* data, const Tokenizer::Token& token)
+{
+    const size_t size = token.nameEnd - token.nameBegin;
+
+    // A stray end tag is dropped without walking the open elements
+    if (!m_OpenNames.contains(StringSpan(data + token.nameBegin, size)))
+    {
+        return;
+    }
+
+    for (size_t i = m_Depth; i > 0; --i)
+    {
+        if (m_Names[i - 1].compare(0, std::string::npos, data + token.nameBegin, size) == 0)
+        {
+            while (m_Depth >= i)
+            {
+                closeElement();
+            }
+            return;
+        }
+    }
+}
+
+void SaxParser::closeElement()
+{
+    --m_Depth;
+    m_OpenNames.remove(m_Names[m_Depth]);
+    if (m_Matched[m_Depth])
+    {
+        --m_OpenMatches;
+        m_Handler.endElement(m_Names[m_Depth]);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef DOMPARSER_SAXPARSER_H
+#define DOMPARSER_SAXPARSER_H
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CheckRulesFactory.h"
+#include "ISaxHandler.h"
+#include "OpenNameCounts.h"
+#include "Tag.h"
+#include "Tokenizer.h"
+
+// Drives an ISaxHandler from the Tokenizer output. Only the chain of open
+// elements is kept, so memory depends on the nesting depth, not on the size
+// of the document. Elements are passed to the rule without content.
+// startElement/endElement are reported for the elements the rule accepts,
+// text and comments for everything inside an accepted element.
+class SaxParser
+{
+public:
+    SaxParser(ISaxHandler&, const CheckRulesFactory&);
+    ~SaxParser() = default;
+
+    void parse(const char*, size_t);
+    void handleToken(const char*, const Tokenizer::Token&);
+    void finish();
+
+private:
+    void startElement(const char*, const Tokenizer::Token&);
+    void endElement(const char*, const Tokenizer::Token&);
+    void closeElement();
+
+private:
+    ISaxHandler& m_Handler;
+    const CheckRulesFactory& m_CheckRule;
+    // Reused per nesting level, m_Depth of them are open
+    std::deque<Tag> m_Elements {};
+    std::vector<std::string> m_Names {};
+    std::vector<bool> m_Matched {};
+    OpenNameCounts m_OpenNames {};
+    size_t m_Depth = 0;
+    size_t m_OpenMatches = 0;
+    std::vector<std::pair<std::string, std::string>> m_Attributes {};
+    std::string m_Text {};
+};
+
+#endif //DOMPARSER_SAXPARSER_H
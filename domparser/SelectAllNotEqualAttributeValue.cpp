@@ -1,28 +1,30 @@
 #include "SelectAllNotEqualAttributeValue.h"
 
-SelectAllNotEqualAttributeValue::SelectAllNotEqualAttributeValue(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectAllNotEqualAttributeValue>;
+
+SelectAllNotEqualAttributeValue::SelectAllNotEqualAttributeValue(const std::string& attribute, const std::string& value)
+: m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
 
 bool SelectAllNotEqualAttributeValue::checkRules(Tag* tag) const
 {
-    if (tag != nullptr)
+    if (tag != nullptr && tag->getAttributeCount() == tag->getAttributeValueCount())
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-
-        if (attribute.size() == attributeValue.size())
+        for (const auto& i : tag->getAttributes())
         {
-            for (size_t i = 0; i < attribute.size(); ++i)
+            if (i.atom == m_AttributeAtom && i.value != m_Value)
             {
-                if (attribute[i] == m_Match[2] && attributeValue[i] != m_Match[3])
-                {
-                    return true;
-                }
+                return true;
             }
         }
     }
     return false;
+}
+
+AtomTable::Atom SelectAllNotEqualAttributeValue::getAttributeAtom() const
+{
+    return m_AttributeAtom;
 }
\ No newline at end of file
@@ -1,18 +1,21 @@
 #ifndef DOMPARSER_SELECTALLNOTEQUALATTRIBUTEVALUE_H
 #define DOMPARSER_SELECTALLNOTEQUALATTRIBUTEVALUE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectAllNotEqualAttributeValue : public CheckRulesFactory
+class SelectAllNotEqualAttributeValue final : public CheckRules<SelectAllNotEqualAttributeValue>
 {
 public:
-    explicit SelectAllNotEqualAttributeValue(const std::cmatch&);
+    SelectAllNotEqualAttributeValue(const std::string&, const std::string&);
     virtual ~SelectAllNotEqualAttributeValue() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
+    std::string m_Value;
 };
 
+extern template class CheckRules<SelectAllNotEqualAttributeValue>;
 
 #endif //DOMPARSER_SELECTALLNOTEQUALATTRIBUTEVALUE_H
@@ -1,5 +1,7 @@
 #include "SelectAllRule.h"
 
+template class CheckRules<SelectAllRule>;
+
 bool SelectAllRule::checkRules(Tag *) const
 {
     return true;
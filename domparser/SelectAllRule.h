@@ -1,11 +1,9 @@
 #ifndef DOMPARSER_SELECTALLRULE_H
 #define DOMPARSER_SELECTALLRULE_H
 
-#include <regex>
+#include "CheckRules.h"
 
-#include "CheckRulesFactory.h"
-
-class SelectAllRule : public CheckRulesFactory
+class SelectAllRule final : public CheckRules<SelectAllRule>
 {
 public:
     SelectAllRule() = default;
@@ -13,4 +11,6 @@ public:
     virtual bool checkRules(Tag*) const;
 };
 
+extern template class CheckRules<SelectAllRule>;
+
 #endif //DOMPARSER_SELECTALLRULE_H
@@ -1,22 +1,19 @@
 #include "SelectAllWithAttribute.h"
 
-SelectAllWithAttribute::SelectAllWithAttribute(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectAllWithAttribute>;
+
+SelectAllWithAttribute::SelectAllWithAttribute(const std::string& attribute)
+: m_AttributeAtom(AtomTable::getGlobal().intern(attribute))
 {
 
 }
 
 bool SelectAllWithAttribute::checkRules(Tag* tag) const
 {
-    if (tag != nullptr)
-    {
-        for (const auto &i : tag->getAttributeTag())
-        {
-            if (m_Match[2] == i)
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return tag != nullptr && tag->findAttribute(m_AttributeAtom) != std::string::npos;
+}
+
+AtomTable::Atom SelectAllWithAttribute::getAttributeAtom() const
+{
+    return m_AttributeAtom;
 }
\ No newline at end of file
@@ -1,18 +1,20 @@
 #ifndef DOMPARSER_SELECTALLWITHATTRIBUTE_H
 #define DOMPARSER_SELECTALLWITHATTRIBUTE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectAllWithAttribute : public CheckRulesFactory
+class SelectAllWithAttribute final : public CheckRules<SelectAllWithAttribute>
 {
 public:
-    explicit SelectAllWithAttribute(const std::cmatch&);
+    explicit SelectAllWithAttribute(const std::string&);
     virtual ~SelectAllWithAttribute() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
 };
 
+extern template class CheckRules<SelectAllWithAttribute>;
 
 #endif //DOMPARSER_SELECTALLWITHATTRIBUTE_H
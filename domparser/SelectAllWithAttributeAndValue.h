@@ -1,18 +1,21 @@
 #ifndef DOMPARSER_SELECTALLWITHATTRIBUTEANDVALUE_H
 #define DOMPARSER_SELECTALLWITHATTRIBUTEANDVALUE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectAllWithAttributeAndValue : public CheckRulesFactory
+class SelectAllWithAttributeAndValue final : public CheckRules<SelectAllWithAttributeAndValue>
 {
 public:
-    explicit SelectAllWithAttributeAndValue(const std::cmatch&);
+    SelectAllWithAttributeAndValue(const std::string&, const std::string&);
     virtual ~SelectAllWithAttributeAndValue() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
+    std::string m_Value;
 };
 
+extern template class CheckRules<SelectAllWithAttributeAndValue>;
 
 #endif //DOMPARSER_SELECTALLWITHATTRIBUTEANDVALUE_H
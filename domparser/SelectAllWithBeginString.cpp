@@ -1,9 +1,10 @@
 #include "SelectAllWithBeginString.h"
-#include <algorithm>
-#include <iterator>
 
-SelectAllWithBeginString::SelectAllWithBeginString(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectAllWithBeginString>;
+
+SelectAllWithBeginString::SelectAllWithBeginString(const std::string& attribute, const std::string& value)
+: m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
@@ -12,16 +13,19 @@ bool SelectAllWithBeginString::checkRules(Tag* tag) const
 {
     if (tag != nullptr)
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-        auto attributePosition = std::find(attribute.begin(), attribute.end(), m_Match[2]);
-        std::cmatch cm;
+        // Only the first attribute with the name is checked
+        const size_t position = tag->findAttribute(m_AttributeAtom);
 
-        if (attributePosition != attribute.end() &&
-            std::regex_search(attributeValue[std::distance(attribute.begin(), attributePosition)].data(), cm, std::regex("^(" + m_Match[3] + ")")))
+        if (position != std::string::npos && position < tag->getAttributeValueCount() &&
+            m_Value.isPrefixOf(tag->getAttributeValue(position)))
         {
             return true;
         }
     }
     return false;
+}
+
+AtomTable::Atom SelectAllWithBeginString::getAttributeAtom() const
+{
+    return m_AttributeAtom;
 }
\ No newline at end of file
@@ -1,17 +1,22 @@
 #ifndef DOMPARSER_SELECTALLWITHBEGINSTRING_H
 #define DOMPARSER_SELECTALLWITHBEGINSTRING_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
+#include "ValuePattern.h"
 
-class SelectAllWithBeginString : public CheckRulesFactory
+class SelectAllWithBeginString final : public CheckRules<SelectAllWithBeginString>
 {
 public:
-    explicit SelectAllWithBeginString(const std::cmatch&);
+    SelectAllWithBeginString(const std::string&, const std::string&);
     virtual ~SelectAllWithBeginString() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
+    ValuePattern m_Value;
 };
 
+extern template class CheckRules<SelectAllWithBeginString>;
+
 #endif //DOMPARSER_SELECTALLWITHBEGINSTRING_H
@@ -1,9 +1,10 @@
 #include "SelectAllWithEndString.h"
-#include <algorithm>
-#include <iterator>
 
-SelectAllWithEndString::SelectAllWithEndString(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectAllWithEndString>;
+
+SelectAllWithEndString::SelectAllWithEndString(const std::string& attribute, const std::string& value)
+: m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
@@ -12,16 +13,19 @@ bool SelectAllWithEndString::checkRules(Tag* tag) const
 {
     if (tag != nullptr)
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-        auto attributePosition = std::find(attribute.begin(), attribute.end(), m_Match[2]);
-        std::cmatch cm;
+        // Only the first attribute with the name is checked
+        const size_t position = tag->findAttribute(m_AttributeAtom);
 
-        if (attributePosition != attribute.end() &&
-                std::regex_search(attributeValue[std::distance(attribute.begin(), attributePosition)].data(), cm, std::regex("(" + m_Match[3] + ")$")))
+        if (position != std::string::npos && position < tag->getAttributeValueCount() &&
+            m_Value.isSuffixOf(tag->getAttributeValue(position)))
         {
             return true;
         }
     }
     return false;
+}
+
+AtomTable::Atom SelectAllWithEndString::getAttributeAtom() const
+{
+    return m_AttributeAtom;
 }
\ No newline at end of file
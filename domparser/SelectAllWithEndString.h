@@ -1,18 +1,22 @@
 #ifndef DOMPARSER_SELECTALLWITHENDSTRING_H
 #define DOMPARSER_SELECTALLWITHENDSTRING_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
+#include "ValuePattern.h"
 
-class SelectAllWithEndString : public CheckRulesFactory
+class SelectAllWithEndString final : public CheckRules<SelectAllWithEndString>
 {
 public:
-    explicit SelectAllWithEndString(const std::cmatch&);
+    SelectAllWithEndString(const std::string&, const std::string&);
     virtual ~SelectAllWithEndString() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
+    ValuePattern m_Value;
 };
 
+extern template class CheckRules<SelectAllWithEndString>;
 
 #endif //DOMPARSER_SELECTALLWITHENDSTRING_H
@@ -1,29 +1,30 @@
 #include "SelectAllWithPartString.h"
 
-SelectAllWithPartString::SelectAllWithPartString(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectAllWithPartString>;
+
+SelectAllWithPartString::SelectAllWithPartString(const std::string& attribute, const std::string& value)
+: m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
 
 bool SelectAllWithPartString::checkRules(Tag* tag) const
 {
-    if (tag != nullptr)
+    if (tag != nullptr && tag->getAttributeCount() == tag->getAttributeValueCount())
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-
-        if (attribute.size() == attributeValue.size())
+        for (const auto& i : tag->getAttributes())
         {
-            std::cmatch cm;
-            for (size_t i = 0; i < attribute.size(); ++i)
+            if (i.atom == m_AttributeAtom && m_Value.isPartOf(i.value))
             {
-                if (attribute[i] == m_Match[2] && std::regex_search(attributeValue[i].data(), cm, std::regex("(" + m_Match[3] + ")")))
-                {
-                    return true;
-                }
+                return true;
             }
         }
     }
     return false;
+}
+
+AtomTable::Atom SelectAllWithPartString::getAttributeAtom() const
+{
+    return m_AttributeAtom;
 }
\ No newline at end of file
@@ -1,18 +1,22 @@
 #ifndef DOMPARSER_SELECTALLWITHPARTSTRING_H
 #define DOMPARSER_SELECTALLWITHPARTSTRING_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
+#include "ValuePattern.h"
 
-class SelectAllWithPartString : public CheckRulesFactory
+class SelectAllWithPartString final : public CheckRules<SelectAllWithPartString>
 {
 public:
-    explicit SelectAllWithPartString(const std::cmatch&);
+    SelectAllWithPartString(const std::string&, const std::string&);
     virtual ~SelectAllWithPartString() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_AttributeAtom;
+    ValuePattern m_Value;
 };
 
+extern template class CheckRules<SelectAllWithPartString>;
 
 #endif //DOMPARSER_SELECTALLWITHPARTSTRING_H
@@ -1,7 +1,10 @@
 #include "SelectChildrenOfTheSpecificTag.h"
 
-SelectChildrenOfTheSpecificTag::SelectChildrenOfTheSpecificTag(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectChildrenOfTheSpecificTag>;
+
+SelectChildrenOfTheSpecificTag::SelectChildrenOfTheSpecificTag(const std::string& parentName, const std::string& tagName)
+: m_ParentAtom(AtomTable::getGlobal().intern(parentName)),
+  m_TagAtom(AtomTable::getGlobal().intern(tagName))
 {
 
 }
@@ -10,7 +13,22 @@ bool SelectChildrenOfTheSpecificTag::checkRules(Tag* tag) const
 {
     if (tag != nullptr)
     {
-        return tag->getParent() != nullptr && tag->getParent()->getTagName() == m_Match[1] && tag->getTagName() == m_Match[2];
+        return tag->getParent() != nullptr && tag->getParent()->getTagAtom() == m_ParentAtom && tag->getTagAtom() == m_TagAtom;
     }
     return false;
-}
\ No newline at end of file
+}
+
+AtomTable::Atom SelectChildrenOfTheSpecificTag::getTagAtom() const
+{
+    return m_TagAtom;
+}
+
+bool SelectChildrenOfTheSpecificTag::hasRegions() const
+{
+    return true;
+}
+
+bool SelectChildrenOfTheSpecificTag::isRegionRoot(const Tag& tag) const
+{
+    return tag.getTagAtom() == m_ParentAtom;
+}
@@ -1,17 +1,23 @@
 #ifndef DOMPARSER_SELECTCHILDRENOFTHESPECIFICTAG_H
 #define DOMPARSER_SELECTCHILDRENOFTHESPECIFICTAG_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectChildrenOfTheSpecificTag : public CheckRulesFactory
+class SelectChildrenOfTheSpecificTag final : public CheckRules<SelectChildrenOfTheSpecificTag>
 {
 public:
-    explicit SelectChildrenOfTheSpecificTag(const std::cmatch&);
+    SelectChildrenOfTheSpecificTag(const std::string&, const std::string&);
     virtual ~SelectChildrenOfTheSpecificTag() = default;
     virtual bool checkRules(Tag*) const;
+    virtual bool hasRegions() const;
+    virtual bool isRegionRoot(const Tag&) const;
+    virtual AtomTable::Atom getTagAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_ParentAtom;
+    AtomTable::Atom m_TagAtom;
 };
 
+extern template class CheckRules<SelectChildrenOfTheSpecificTag>;
+
 #endif //DOMPARSER_SELECTCHILDRENOFTHESPECIFICTAG_H
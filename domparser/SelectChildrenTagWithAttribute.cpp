@@ -1,35 +1,44 @@
 #include "SelectChildrenTagWithAttribute.h"
-#include <iterator>
-#include <algorithm>
 
-SelectChildrenTagWithAttribute::SelectChildrenTagWithAttribute(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectChildrenTagWithAttribute>;
+
+SelectChildrenTagWithAttribute::SelectChildrenTagWithAttribute(const std::string& parentName, const std::string& parentAttribute, const std::string& parentValue,
+                                                               const std::string& attribute, const std::string& value)
+: m_ParentAtom(AtomTable::getGlobal().intern(parentName)),
+  m_ParentAttributeAtom(AtomTable::getGlobal().intern(parentAttribute)),
+  m_ParentValue(parentValue),
+  m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
 
+bool SelectChildrenTagWithAttribute::hasAttribute(const Tag& tag, AtomTable::Atom attribute, const std::string& value) const
+{
+    const size_t position = tag.findAttribute(attribute);
+    return position != std::string::npos && position < tag.getAttributeValueCount() && tag.getAttributeValue(position) == value;
+}
+
 bool SelectChildrenTagWithAttribute::checkRules(Tag* tag) const
 {
-    if (tag != nullptr && tag->getParent() != nullptr && tag->getParent()->getTagName() == m_Match[1])
+    if (tag != nullptr && tag->getParent() != nullptr && tag->getParent()->getTagAtom() == m_ParentAtom)
     {
-        auto parent = tag->getParent();
-        auto parentAttributes = parent->getAttributeTag();
-        auto parentAttributesValue = parent->getAttributeValueTag();
-        auto parentAttributePosition = std::find(parentAttributes.begin(), parentAttributes.end(), m_Match[3]);
-
-        if (parentAttributePosition != parentAttributes.end() &&
-            parentAttributesValue[std::distance(parentAttributes.begin(), parentAttributePosition)] == m_Match[4])
-        {
-            auto attribute = tag->getAttributeTag();
-            auto attributeValue = tag->getAttributeValueTag();
-            auto attributePosition = std::find(attribute.begin(), attribute.end(), m_Match[6]);
-
-            if (attributePosition != attribute.end() &&
-                    attributeValue[std::distance(attribute.begin(), attributePosition)] == m_Match[7])
-            {
-                return true;
-            }
-        }
+        return hasAttribute(*tag->getParent(), m_ParentAttributeAtom, m_ParentValue) && hasAttribute(*tag, m_AttributeAtom, m_Value);
     }
     return false;
-}
\ No newline at end of file
+}
+
+AtomTable::Atom SelectChildrenTagWithAttribute::getAttributeAtom() const
+{
+    return m_AttributeAtom;
+}
+
+bool SelectChildrenTagWithAttribute::hasRegions() const
+{
+    return true;
+}
+
+bool SelectChildrenTagWithAttribute::isRegionRoot(const Tag& tag) const
+{
+    return tag.getTagAtom() == m_ParentAtom && hasAttribute(tag, m_ParentAttributeAtom, m_ParentValue);
+}
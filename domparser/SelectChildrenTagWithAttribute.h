@@ -1,17 +1,29 @@
 #ifndef DOMPARSER_SELECTCHILDRENTAGWITHATTRIBUTE_H
 #define DOMPARSER_SELECTCHILDRENTAGWITHATTRIBUTE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectChildrenTagWithAttribute : public CheckRulesFactory
+class SelectChildrenTagWithAttribute final : public CheckRules<SelectChildrenTagWithAttribute>
 {
 public:
-    explicit SelectChildrenTagWithAttribute(const std::cmatch&);
+    SelectChildrenTagWithAttribute(const std::string&, const std::string&, const std::string&, const std::string&, const std::string&);
     virtual ~SelectChildrenTagWithAttribute() = default;
     virtual bool checkRules(Tag*) const;
+    virtual bool hasRegions() const;
+    virtual bool isRegionRoot(const Tag&) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    bool hasAttribute(const Tag&, AtomTable::Atom, const std::string&) const;
+
+private:
+    AtomTable::Atom m_ParentAtom;
+    AtomTable::Atom m_ParentAttributeAtom;
+    std::string m_ParentValue;
+    AtomTable::Atom m_AttributeAtom;
+    std::string m_Value;
 };
 
+extern template class CheckRules<SelectChildrenTagWithAttribute>;
+
 #endif //DOMPARSER_SELECTCHILDRENTAGWITHATTRIBUTE_H
@@ -0,0 +1,463 @@
+#include "SelectCssSelector.h"
+#include "Document.h"
+
+#include <utility>
+
+template class CheckRules<SelectCssSelector, true>;
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+}
+
+SelectCssSelector::SelectCssSelector(SelectorProgram program)
+: m_Program(std::move(program))
+{
+    using Op = SelectorProgram::Op;
+
+    const AtomTable::Atom idAtom = AtomTable::getGlobal().intern("id");
+    const AtomTable::Atom classAtom = AtomTable::getGlobal().intern("class");
+
+    for (const auto entry : m_Program.entries)
+    {
+        m_AncestorKeys.emplace_back();
+        // A compound left of "A > B" or "A B" matches an ancestor of the tag,
+        // also when sibling combinators come between it and the tag
+        bool ancestor = false;
+
+        for (uint32_t i = entry; m_Program.code[i].op != Op::Match && m_AncestorKeys.back().size() < 4; ++i)
+        {
+            const auto& instruction = m_Program.code[i];
+
+            switch (instruction.op)
+            {
+                case Op::Not:
+                    i += instruction.value;
+                    break;
+
+                case Op::Parent:
+                case Op::Ancestor:
+                    ancestor = true;
+                    break;
+
+                case Op::PreviousSibling:
+                case Op::AnyPreviousSibling:
+                    ancestor = false;
+                    break;
+
+                case Op::TagName:
+                    if (ancestor)
+                    {
+                        m_AncestorKeys.back().push_back(AncestorFilter::hashTag(instruction.atom));
+                    }
+                    break;
+
+                case Op::AttributeEquals:
+                    if (ancestor && instruction.atom == idAtom)
+                    {
+                        m_AncestorKeys.back().push_back(AncestorFilter::hashId(m_Program.values[instruction.value]));
+                    }
+                    break;
+
+                case Op::AttributeIncludes:
+                    if (ancestor && instruction.atom == classAtom)
+                    {
+                        m_AncestorKeys.back().push_back(AncestorFilter::hashClass(m_Program.values[instruction.value]));
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        m_UsesAncestorFilter = m_UsesAncestorFilter || !m_AncestorKeys.back().empty();
+    }
+
+    for (const auto& i : m_Program.code)
+    {
+        m_NeedsFollowingContent = m_NeedsFollowingContent || i.op == Op::Empty || i.op == Op::NthLastChild || i.op == Op::NthLastOfType;
+        m_NeedsDocument = m_NeedsDocument || (i.op >= Op::NthChild && i.op <= Op::Empty) || i.op >= Op::PreviousSibling;
+    }
+
+    // The leftmost compound of "A > B", "A B", or of a selector without combinators, holds every match
+    // in its subtree. Sibling combinators keep the parent, so they may come right of it.
+    for (const auto entry : m_Program.entries)
+    {
+        uint32_t start = entry;
+        bool ancestor = true;
+        uint32_t i = entry;
+
+        for (; m_Program.code[i].op != Op::Match; ++i)
+        {
+            const auto op = m_Program.code[i].op;
+
+            if (op == Op::Not)
+            {
+                i += m_Program.code[i].value;
+            }
+            else if (op >= Op::Parent)
+            {
+                start = i + 1;
+                ancestor = op == Op::Parent || op == Op::Ancestor;
+            }
+        }
+
+        // It is tested on a tag whose parent, siblings and content are not known yet
+        for (i = start; ancestor && m_Program.code[i].op != Op::Match; ++i)
+        {
+            ancestor = m_Program.code[i].op == Op::Not || isRegionTest(m_Program.code[i].op);
+        }
+
+        if (!ancestor)
+        {
+            m_RegionStarts.clear();
+            break;
+        }
+        m_RegionStarts.push_back(start);
+    }
+
+    if (m_Program.entries.size() == 1)
+    {
+        const auto& first = m_Program.code[m_Program.entries.front()];
+
+        if (first.op == Op::TagName)
+        {
+            m_TagAtom = first.atom;
+        }
+        else if (first.op >= Op::HasAttribute && first.op <= Op::AttributeSubstring)
+        {
+            m_AttributeAtom = first.atom;
+            // "#id" and ".class"
+            if ((first.op == Op::AttributeEquals && first.atom == AtomTable::getGlobal().intern("id")) ||
+                (first.op == Op::AttributeIncludes && first.atom == AtomTable::getGlobal().intern("class")))
+            {
+                m_KeyValue = first.value;
+            }
+        }
+    }
+}
+
+bool SelectCssSelector::checkRules(Tag* tag) const
+{
+    if (tag != nullptr)
+    {
+        for (const auto entry : m_Program.entries)
+        {
+            if (matchFrom(entry, tag))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SelectCssSelector::checkRules(Tag* tag, const AncestorFilter& filter) const
+{
+    if (tag != nullptr)
+    {
+        for (size_t i = 0; i < m_Program.entries.size(); ++i)
+        {
+            bool possible = true;
+
+            for (const auto key : m_AncestorKeys[i])
+            {
+                if (!filter.mayContain(key))
+                {
+                    possible = false;
+                    break;
+                }
+            }
+
+            if (possible && matchFrom(m_Program.entries[i], tag))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SelectCssSelector::usesAncestorFilter() const
+{
+    return m_UsesAncestorFilter;
+}
+
+bool SelectCssSelector::needsFollowingContent() const
+{
+    return m_NeedsFollowingContent;
+}
+
+bool SelectCssSelector::needsDocument() const
+{
+    return m_NeedsDocument;
+}
+
+bool SelectCssSelector::hasRegions() const
+{
+    return !m_RegionStarts.empty();
+}
+
+bool SelectCssSelector::isRegionRoot(const Tag& tag) const
+{
+    if (m_RegionStarts.empty())
+    {
+        return true;
+    }
+
+    for (const auto start : m_RegionStarts)
+    {
+        if (matchFrom(start, &tag))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+AtomTable::Atom SelectCssSelector::getTagAtom() const
+{
+    return m_TagAtom;
+}
+
+AtomTable::Atom SelectCssSelector::getAttributeAtom() const
+{
+    return m_AttributeAtom;
+}
+
+const std::string* SelectCssSelector::getKeyValue() const
+{
+    return m_KeyValue == UINT32_MAX ? nullptr : &m_Program.values[m_KeyValue];
+}
+
+bool SelectCssSelector::matchFrom(uint32_t position, const Tag* tag) const
+{
+    using Op = SelectorProgram::Op;
+
+    for (;; ++position)
+    {
+        const auto& instruction = m_Program.code[position];
+
+        switch (instruction.op)
+        {
+            case Op::Match:
+                return true;
+
+            case Op::Not:
+            {
+                const uint32_t end = position + 1 + instruction.value;
+                bool matched = true;
+
+                for (uint32_t i = position + 1; i < end && matched; ++i)
+                {
+                    matched = test(m_Program.code[i], *tag);
+                }
+
+                if (matched)
+                {
+                    return false;
+                }
+                position = end - 1;
+                break;
+            }
+
+            case Op::Parent:
+                tag = tag->getParent();
+                if (tag == nullptr)
+                {
+                    return false;
+                }
+                break;
+
+            case Op::Ancestor:
+                // The only place that backtracks: every ancestor is a candidate for the rest of the selector
+                for (tag = tag->getParent(); tag != nullptr; tag = tag->getParent())
+                {
+                    if (matchFrom(position + 1, tag))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+
+            case Op::PreviousSibling:
+                tag = getPreviousSibling(*tag);
+                if (tag == nullptr)
+                {
+                    return false;
+                }
+                break;
+
+            case Op::AnyPreviousSibling:
+                for (tag = getPreviousSibling(*tag); tag != nullptr; tag = getPreviousSibling(*tag))
+                {
+                    if (matchFrom(position + 1, tag))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+
+            default:
+                if (!test(instruction, *tag))
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+}
+
+bool SelectCssSelector::test(const SelectorProgram::Instruction& instruction, const Tag& tag) const
+{
+    using Op = SelectorProgram::Op;
+
+    switch (instruction.op)
+    {
+        case Op::TagName:
+            return tag.getTagAtom() == instruction.atom;
+
+        case Op::NthChild:
+        case Op::NthLastChild:
+        case Op::NthOfType:
+        case Op::NthLastOfType:
+            return matchesNth(instruction, tag);
+
+        case Op::Empty:
+            // Whitespace is text, comments are not
+            return tag.getFirstChildIndex() == Document::npos && !tag.hasText();
+
+        case Op::Root:
+            return tag.getParent() == nullptr;
+
+        default:
+            return testAttribute(instruction, tag);
+    }
+}
+
+bool SelectCssSelector::testAttribute(const SelectorProgram::Instruction& instruction, const Tag& tag) const
+{
+    using Op = SelectorProgram::Op;
+
+    const size_t index = tag.findAttribute(instruction.atom);
+
+    if (index == std::string::npos)
+    {
+        return false;
+    }
+
+    if (instruction.op == Op::HasAttribute)
+    {
+        return true;
+    }
+    const StringSpan value = index < tag.getAttributeValueCount() ? tag.getAttributeValue(index) : StringSpan();
+    const StringSpan expected(m_Program.values[instruction.value]);
+
+    switch (instruction.op)
+    {
+        case Op::AttributeEquals:
+            return value == expected;
+
+        case Op::AttributeIncludes:
+            return includesWord(value, expected);
+
+        case Op::AttributeDashMatch:
+            return value.startsWith(expected) && (value.size() == expected.size() || value[expected.size()] == '-');
+
+        // An empty string never matches these, as the specification requires
+        case Op::AttributePrefix:
+            return !expected.empty() && value.startsWith(expected);
+
+        case Op::AttributeSuffix:
+            return !expected.empty() && value.endsWith(expected);
+
+        case Op::AttributeSubstring:
+            return !expected.empty() && value.contains(expected);
+
+        default:
+            return false;
+    }
+}
+
+bool SelectCssSelector::includesWord(const StringSpan& value, const StringSpan& word)
+{
+    if (word.empty())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < value.size();)
+    {
+        if (isSpace(value[i]))
+        {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+
+        while (end < value.size() && !isSpace(value[end]))
+        {
+            ++end;
+        }
+
+        if (StringSpan(value.data() + i, end - i) == word)
+        {
+            return true;
+        }
+        i = end;
+    }
+    return false;
+}
+
+bool SelectCssSelector::matchesNth(const SelectorProgram::Instruction& instruction, const Tag& tag)
+{
+    using Op = SelectorProgram::Op;
+
+    const bool fromEnd = instruction.op == Op::NthLastChild || instruction.op == Op::NthLastOfType;
+    const bool ofType = instruction.op == Op::NthOfType || instruction.op == Op::NthLastOfType;
+    int64_t position = 1;
+    const Document* document = tag.getDocument();
+
+    if (document != nullptr)
+    {
+        uint32_t i = fromEnd ? tag.getNextSiblingIndex() : tag.getPreviousSiblingIndex();
+
+        while (i != Document::npos)
+        {
+            const Tag& sibling = document->getNode(i);
+
+            if (!ofType || sibling.hasSameTagName(tag))
+            {
+                ++position;
+            }
+            i = fromEnd ? sibling.getNextSiblingIndex() : sibling.getPreviousSiblingIndex();
+        }
+    }
+    const int64_t offset = position - instruction.b;
+
+    if (instruction.a == 0)
+    {
+        return offset == 0;
+    }
+    return offset / instruction.a >= 0 && offset % instruction.a == 0;
+}
+
+const Tag* SelectCssSelector::getPreviousSibling(const Tag& tag)
+{
+    const Document* document = tag.getDocument();
+
+    if (document == nullptr || tag.getPreviousSiblingIndex() == Document::npos)
+    {
+        return nullptr;
+    }
+    return &document->getNode(tag.getPreviousSiblingIndex());
+}
+
+bool SelectCssSelector::isRegionTest(SelectorProgram::Op op)
+{
+    using Op = SelectorProgram::Op;
+    return op >= Op::TagName && op <= Op::AttributeSubstring;
+}
@@ -0,0 +1,53 @@
+#ifndef DOMPARSER_SELECTCSSSELECTOR_H
+#define DOMPARSER_SELECTCSSSELECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "CheckRules.h"
+#include "SelectorProgram.h"
+
+// Runs a compiled CSS selector list against a tag, right to left
+class SelectCssSelector final : public CheckRules<SelectCssSelector, true>
+{
+public:
+    explicit SelectCssSelector(SelectorProgram);
+    virtual ~SelectCssSelector() = default;
+    virtual bool checkRules(Tag*) const;
+    virtual bool checkRules(Tag*, const AncestorFilter&) const;
+    virtual bool usesAncestorFilter() const;
+    virtual bool needsFollowingContent() const;
+    virtual bool needsDocument() const;
+    virtual bool hasRegions() const;
+    virtual bool isRegionRoot(const Tag&) const;
+    virtual AtomTable::Atom getTagAtom() const;
+    virtual AtomTable::Atom getAttributeAtom() const;
+    virtual const std::string* getKeyValue() const;
+
+private:
+    bool matchFrom(uint32_t, const Tag*) const;
+    bool test(const SelectorProgram::Instruction&, const Tag&) const;
+    bool testAttribute(const SelectorProgram::Instruction&, const Tag&) const;
+    static bool includesWord(const StringSpan&, const StringSpan&);
+    static bool matchesNth(const SelectorProgram::Instruction&, const Tag&);
+    static const Tag* getPreviousSibling(const Tag&);
+    static bool isRegionTest(SelectorProgram::Op);
+
+private:
+    SelectorProgram m_Program;
+    // Taken from the first instruction of a single selector
+    AtomTable::Atom m_TagAtom = AtomTable::None;
+    AtomTable::Atom m_AttributeAtom = AtomTable::None;
+    uint32_t m_KeyValue = UINT32_MAX; // Index into the values of the program
+    // For every entry, filter keys of the compounds that have to match an ancestor
+    std::vector<std::vector<uint32_t>> m_AncestorKeys {};
+    bool m_UsesAncestorFilter = false;
+    bool m_NeedsFollowingContent = false;
+    bool m_NeedsDocument = false;
+    // For every entry, where its leftmost compound starts. Empty if a selector has no region.
+    std::vector<uint32_t> m_RegionStarts {};
+};
+
+extern template class CheckRules<SelectCssSelector, true>;
+
+#endif //DOMPARSER_SELECTCSSSELECTOR_H
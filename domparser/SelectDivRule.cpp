@@ -1,16 +1,23 @@
 #include "SelectDivRule.h"
 
-SelectDivRule::SelectDivRule(const std::cmatch& cm)
-: m_Match(cm)
+template class CheckRules<SelectDivRule>;
+
+SelectDivRule::SelectDivRule(const std::string& tagName)
+: m_TagAtom(AtomTable::getGlobal().intern(tagName))
 {
 
 }
 
 bool SelectDivRule::checkRules(Tag* tag) const
 {
-    if (tag != nullptr && m_Match.str() == tag->getTagName())
+    if (tag != nullptr && tag->getTagAtom() == m_TagAtom)
     {
         return true;
     }
     return false;
+}
+
+AtomTable::Atom SelectDivRule::getTagAtom() const
+{
+    return m_TagAtom;
 }
\ No newline at end of file
@@ -1,18 +1,20 @@
 #ifndef DOMPARSER_SELECTDIVRULE_H
 #define DOMPARSER_SELECTDIVRULE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectDivRule : public CheckRulesFactory
+class SelectDivRule final : public CheckRules<SelectDivRule>
 {
 public:
-    explicit SelectDivRule(const std::cmatch&);
+    explicit SelectDivRule(const std::string&);
     virtual ~SelectDivRule() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getTagAtom() const;
 
 private:
-    std::cmatch m_Match;
+    AtomTable::Atom m_TagAtom;
 };
 
+extern template class CheckRules<SelectDivRule>;
 
 #endif //DOMPARSER_SELECTDIVRULE_H
@@ -1,26 +1,31 @@
 #include "SelectSpecificTagWithSpecifiedAttribute.h"
-#include <algorithm>
-#include <iterator>
 
-SelectSpecificTagWithSpecifiedAttribute::SelectSpecificTagWithSpecifiedAttribute(const std::cmatch& cm)
-: m_Match(cm.begin(), cm.end())
+template class CheckRules<SelectSpecificTagWithSpecifiedAttribute>;
+
+SelectSpecificTagWithSpecifiedAttribute::SelectSpecificTagWithSpecifiedAttribute(const std::string& tagName, const std::string& attribute, const std::string& value)
+: m_TagAtom(AtomTable::getGlobal().intern(tagName)),
+  m_AttributeAtom(AtomTable::getGlobal().intern(attribute)),
+  m_Value(value)
 {
 
 }
 
 bool SelectSpecificTagWithSpecifiedAttribute::checkRules(Tag* tag) const
 {
-    if (tag != nullptr && tag->getTagName() == m_Match[2])
+    if (tag != nullptr && tag->getTagAtom() == m_TagAtom)
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-        auto attributePosition = std::find(attribute.begin(), attribute.end(), m_Match[3]);
+        const size_t position = tag->findAttribute(m_AttributeAtom);
 
-        if (attributePosition != attribute.end() &&
-            attributeValue[std::distance(attribute.begin(), attributePosition)] == m_Match[4])
+        if (position != std::string::npos && position < tag->getAttributeValueCount() &&
+            tag->getAttributeValue(position) == m_Value)
         {
             return true;
         }
     }
     return false;
+}
+
+AtomTable::Atom SelectSpecificTagWithSpecifiedAttribute::getTagAtom() const
+{
+    return m_TagAtom;
 }
\ No newline at end of file
@@ -1,18 +1,22 @@
 #ifndef DOMPARSER_SELECTSPECIFICTAGWITHSPECIFIEDATTRIBUTE_H
 #define DOMPARSER_SELECTSPECIFICTAGWITHSPECIFIEDATTRIBUTE_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
 
-class SelectSpecificTagWithSpecifiedAttribute : public CheckRulesFactory
+class SelectSpecificTagWithSpecifiedAttribute final : public CheckRules<SelectSpecificTagWithSpecifiedAttribute>
 {
 public:
-    explicit SelectSpecificTagWithSpecifiedAttribute(const std::cmatch&);
+    SelectSpecificTagWithSpecifiedAttribute(const std::string&, const std::string&, const std::string&);
     virtual ~SelectSpecificTagWithSpecifiedAttribute() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getTagAtom() const;
 
 private:
-    std::vector<std::string> m_Match;
+    AtomTable::Atom m_TagAtom;
+    AtomTable::Atom m_AttributeAtom;
+    std::string m_Value;
 };
 
+extern template class CheckRules<SelectSpecificTagWithSpecifiedAttribute>;
 
 #endif //DOMPARSER_SELECTSPECIFICTAGWITHSPECIFIEDATTRIBUTE_H
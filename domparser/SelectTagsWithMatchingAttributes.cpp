@@ -1,48 +1,34 @@
 #include "SelectTagsWithMatchingAttributes.h"
-#include <functional>
-#include <algorithm>
 
-SelectTagsWithMatchingAttributes::SelectTagsWithMatchingAttributes(const std::string& rule, const std::string& reg)
-: m_FullRule(rule),
-  m_RegexValue(reg)
-{
+template class CheckRules<SelectTagsWithMatchingAttributes>;
 
+SelectTagsWithMatchingAttributes::SelectTagsWithMatchingAttributes(const std::vector<std::pair<std::string, std::string>>& attributes)
+{
+    m_Attributes.reserve(attributes.size());
+    for (const auto& i : attributes)
+    {
+        m_Attributes.emplace_back(AtomTable::getGlobal().intern(i.first), ValuePattern(i.second));
+    }
 }
 
 bool SelectTagsWithMatchingAttributes::checkRules(Tag* tag) const
 {
-    if (tag != nullptr)
+    if (tag != nullptr && tag->getAttributeCount() == tag->getAttributeValueCount())
     {
-        auto attribute = tag->getAttributeTag();
-        auto attributeValue = tag->getAttributeValueTag();
-
-        if (attribute.size() == attributeValue.size())
+        for (const auto& i : m_Attributes)
         {
-            try
+            const size_t position = tag->findAttribute(i.first);
+            if (position == std::string::npos || !i.second.isPartOf(tag->getAttributeValue(position)))
             {
-                std::sregex_iterator next(m_FullRule.begin(), m_FullRule.end(), m_RegexValue);
-                std::sregex_iterator end;
-                std::smatch sm;
-
-                while (next != end)
-                {
-                    sm = *next;
-                    auto attributePosition = std::find(attribute.begin(), attribute.end(), sm[2].str());
-                    std::cmatch loc;
-                    if (attributePosition == attribute.end() ||
-                        !std::regex_search(attributeValue[std::distance(attribute.begin(), attributePosition)].data(), loc, std::regex("(" + sm[3].str() + ")")))
-                    {
-                        return false;
-                    }
-                    ++next;
-                }
-                return true;
-            }
-            catch (const std::regex_error&)
-            {
-                throw;
+                return false;
             }
         }
+        return true;
     }
     return false;
+}
+
+AtomTable::Atom SelectTagsWithMatchingAttributes::getAttributeAtom() const
+{
+    return m_Attributes.front().first;
 }
\ No newline at end of file
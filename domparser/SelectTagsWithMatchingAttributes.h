@@ -1,19 +1,21 @@
 #ifndef DOMPARSER_SELECTTAGSWITHMATCHINGATTRIBUTES_H
 #define DOMPARSER_SELECTTAGSWITHMATCHINGATTRIBUTES_H
 
-#include "CheckRulesFactory.h"
+#include "CheckRules.h"
+#include "ValuePattern.h"
 
-class SelectTagsWithMatchingAttributes : public CheckRulesFactory
+class SelectTagsWithMatchingAttributes final : public CheckRules<SelectTagsWithMatchingAttributes>
 {
 public:
-    SelectTagsWithMatchingAttributes(const std::string&, const std::string&);
+    explicit SelectTagsWithMatchingAttributes(const std::vector<std::pair<std::string, std::string>>&);
     virtual ~SelectTagsWithMatchingAttributes() = default;
     virtual bool checkRules(Tag*) const;
+    virtual AtomTable::Atom getAttributeAtom() const;
 
 private:
-    std::string m_FullRule;
-    std::regex m_RegexValue;
+    std::vector<std::pair<AtomTable::Atom, ValuePattern>> m_Attributes;
 };
 
+extern template class CheckRules<SelectTagsWithMatchingAttributes>;
 
 #endif //DOMPARSER_SELECTTAGSWITHMATCHINGATTRIBUTES_H
@@ -0,0 +1,47 @@
+#include "SelectorCache.h"
+
+SelectorCache::SelectorCache(size_t capacity)
+: m_Capacity(capacity)
+{
+
+}
+
+SelectorCache& SelectorCache::getGlobal()
+{
+    static SelectorCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CheckRulesFactory> SelectorCache::get(const std::string& rule)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto position = m_Rules.find(rule);
+        if (position != m_Rules.end())
+        {
+            return position->second;
+        }
+    }
+
+    // Compiled without the lock; if another thread was faster its rule is kept
+    std::shared_ptr<const CheckRulesFactory> compiled(CheckRulesFactory::createCheckRulesFactory(rule));
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_Rules.size() >= m_Capacity)
+    {
+        m_Rules.clear();
+    }
+    return m_Rules.emplace(rule, std::move(compiled)).first->second;
+}
+
+void SelectorCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Rules.clear();
+}
+
+size_t SelectorCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Rules.size();
+}
@@ -0,0 +1,35 @@
+#ifndef DOMPARSER_SELECTORCACHE_H
+#define DOMPARSER_SELECTORCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "CheckRulesFactory.h"
+
+// Compiled rules keyed by their text. Rules are immutable once compiled, so
+// one instance is shared by every page and thread that uses the same text.
+class SelectorCache
+{
+public:
+    explicit SelectorCache(size_t = 1024); // Number of rules kept
+    ~SelectorCache() = default;
+
+    SelectorCache(const SelectorCache&) = delete;
+    SelectorCache& operator=(const SelectorCache&) = delete;
+
+    static SelectorCache& getGlobal();
+
+    // nullptr if the rule is incorrect
+    std::shared_ptr<const CheckRulesFactory> get(const std::string&);
+    void clear();
+    size_t getSize() const;
+
+private:
+    mutable std::mutex m_Mutex {};
+    size_t m_Capacity;
+    std::unordered_map<std::string, std::shared_ptr<const CheckRulesFactory>> m_Rules {};
+};
+
+#endif //DOMPARSER_SELECTORCACHE_H
@@ -0,0 +1,277 @@
+#ifndef DOMPARSER_SELECTORDSL_H
+#define DOMPARSER_SELECTORDSL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CheckRules.h"
+#include "Document.h"
+#include "KnownNames.h"
+#include "StringSpan.h"
+#include "Tag.h"
+
+// Selectors written as types, for the ones known at build time. The parts are
+// listed as in CSS and matched right to left like the compiled selectors, but
+// every test is inlined: names are compared as the atoms of known names and
+// values with a length known at compile time. Names that are not HTML names
+// are added with DOMPARSER_USER_NAMES. Values are constexpr character arrays,
+// C++14 has no string literal template arguments. The ancestor filter is not
+// kept, so on deep pages a compiled descendant selector can be faster.
+//
+//     constexpr char price[] = "price";
+//     using Prices = dom::select<dom::tag<KnownName::Div>, dom::child, dom::hasClass<price>>;
+//
+//     std::vector<uint32_t> result;
+//     dom::selectNodes<Prices>(document, result);
+//     // or as any other rule
+//     std::unique_ptr<CheckRulesFactory> rule(new dom::Rule<Prices>());
+namespace dom
+{
+    namespace detail
+    {
+        constexpr size_t length(const char* str)
+        {
+            size_t result = 0;
+            while (str[result] != '\0')
+            {
+                ++result;
+            }
+            return result;
+        }
+
+        template <const char* Value>
+        bool equals(const StringSpan& value)
+        {
+            constexpr size_t size = length(Value);
+            return value.size() == size && std::memcmp(value.data(), Value, size) == 0;
+        }
+
+        inline bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+        }
+
+        template <const char* Word>
+        bool includesWord(const StringSpan& value)
+        {
+            constexpr size_t size = length(Word);
+            static_assert(size > 0, "A class or word can not be empty");
+
+            for (size_t i = 0; i + size <= value.size(); ++i)
+            {
+                if ((i == 0 || isSpace(value[i - 1])) && (i + size == value.size() || isSpace(value[i + size])) &&
+                    std::memcmp(value.data() + i, Word, size) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Value of the first attribute with the name, false when the tag has none
+        inline bool findValue(const Tag& node, KnownName name, StringSpan& value)
+        {
+            const size_t index = node.findAttribute(static_cast<AtomTable::Atom>(name));
+            if (index == std::string::npos)
+            {
+                return false;
+            }
+            value = index < node.getAttributeValueCount() ? node.getAttributeValue(index) : StringSpan();
+            return true;
+        }
+
+        inline const Tag* getPreviousSibling(const Tag& node)
+        {
+            const uint32_t index = node.getPreviousSiblingIndex();
+            return index == Document::npos || node.getDocument() == nullptr ? nullptr : &node.getDocument()->getNode(index);
+        }
+    }
+
+    // Simple selectors, the ones that follow each other form a compound
+
+    // "div"
+    template <KnownName Name>
+    struct tag
+    {
+        static bool test(const Tag& node)
+        {
+            return node.getTagAtom() == static_cast<AtomTable::Atom>(Name);
+        }
+    };
+
+    // "[name]"
+    template <KnownName Name>
+    struct hasAttr
+    {
+        static bool test(const Tag& node)
+        {
+            return node.findAttribute(static_cast<AtomTable::Atom>(Name)) != std::string::npos;
+        }
+    };
+
+    // "[name='value']"
+    template <KnownName Name, const char* Value>
+    struct attr
+    {
+        static bool test(const Tag& node)
+        {
+            StringSpan value;
+            return detail::findValue(node, Name, value) && detail::equals<Value>(value);
+        }
+    };
+
+    // "[name~='word']"
+    template <KnownName Name, const char* Word>
+    struct attrWord
+    {
+        static bool test(const Tag& node)
+        {
+            StringSpan value;
+            return detail::findValue(node, Name, value) && detail::includesWord<Word>(value);
+        }
+    };
+
+    // "#value"
+    template <const char* Value>
+    using id = attr<KnownName::Id, Value>;
+
+    // ".word"
+    template <const char* Word>
+    using hasClass = attrWord<KnownName::Class, Word>;
+
+    // Combinators, between the compounds
+
+    struct child {};       // "A > B"
+    struct descendant {};  // "A B"
+    struct adjacent {};    // "A + B"
+    struct sibling {};     // "A ~ B"
+
+    namespace detail
+    {
+        template <typename...>
+        struct List {};
+
+        template <typename, typename>
+        struct Reverse;
+
+        template <typename... Out>
+        struct Reverse<List<>, List<Out...>>
+        {
+            using type = List<Out...>;
+        };
+
+        template <typename Head, typename... Tail, typename... Out>
+        struct Reverse<List<Head, Tail...>, List<Out...>> : Reverse<List<Tail...>, List<Head, Out...>> {};
+
+        // The parts from right to left, the tag moves with the combinators
+        template <typename>
+        struct Match;
+
+        template <>
+        struct Match<List<>>
+        {
+            static bool match(const Tag&)
+            {
+                return true;
+            }
+        };
+
+        template <typename Simple, typename... Rest>
+        struct Match<List<Simple, Rest...>>
+        {
+            static bool match(const Tag& node)
+            {
+                return Simple::test(node) && Match<List<Rest...>>::match(node);
+            }
+        };
+
+        template <typename... Rest>
+        struct Match<List<child, Rest...>>
+        {
+            static bool match(const Tag& node)
+            {
+                const Tag* parent = node.getParent();
+                return parent != nullptr && Match<List<Rest...>>::match(*parent);
+            }
+        };
+
+        template <typename... Rest>
+        struct Match<List<descendant, Rest...>>
+        {
+            static bool match(const Tag& node)
+            {
+                for (const Tag* ancestor = node.getParent(); ancestor != nullptr; ancestor = ancestor->getParent())
+                {
+                    if (Match<List<Rest...>>::match(*ancestor))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        template <typename... Rest>
+        struct Match<List<adjacent, Rest...>>
+        {
+            static bool match(const Tag& node)
+            {
+                const Tag* previous = getPreviousSibling(node);
+                return previous != nullptr && Match<List<Rest...>>::match(*previous);
+            }
+        };
+
+        template <typename... Rest>
+        struct Match<List<sibling, Rest...>>
+        {
+            static bool match(const Tag& node)
+            {
+                for (const Tag* previous = getPreviousSibling(node); previous != nullptr; previous = getPreviousSibling(*previous))
+                {
+                    if (Match<List<Rest...>>::match(*previous))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+    }
+
+    template <typename... Parts>
+    struct select
+    {
+        static_assert(sizeof...(Parts) > 0, "A selector needs at least one part");
+
+        static bool matches(const Tag& node)
+        {
+            return detail::Match<typename detail::Reverse<detail::List<Parts...>, detail::List<>>::type>::match(node);
+        }
+    };
+
+    // The selector as a rule, for the code that takes a CheckRulesFactory
+    template <typename Selector>
+    class Rule final : public CheckRules<Rule<Selector>>
+    {
+    public:
+        virtual bool checkRules(Tag* tag) const
+        {
+            return tag != nullptr && Selector::matches(*tag);
+        }
+    };
+
+    // Same loop as CheckRulesFactory::selectNodes, with the selector inlined into it
+    template <typename Selector>
+    void selectNodes(Document& document, std::vector<uint32_t>& result, size_t limit = SIZE_MAX)
+    {
+        selectDocumentNodes(document, false, result, limit, [](Tag* tag, const AncestorFilter&)
+        {
+            return Selector::matches(*tag);
+        });
+    }
+}
+
+#endif //DOMPARSER_SELECTORDSL_H
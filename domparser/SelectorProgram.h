@@ -0,0 +1,53 @@
+#ifndef DOMPARSER_SELECTORPROGRAM_H
+#define DOMPARSER_SELECTORPROGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AtomTable.h"
+
+// Compiled CSS selector list. Each selector of the list is an entry point
+// into the code. Its instructions test the candidate tag first and then move
+// to the left through the combinators, as browser engines match selectors.
+struct SelectorProgram
+{
+    enum class Op : uint8_t
+    {
+        Match,              // The selector matched
+        TagName,            // atom
+        HasAttribute,       // atom
+        AttributeEquals,    // atom, value ("#id" as well)
+        AttributeIncludes,  // atom, value: one of the whitespace separated words (".class" as well)
+        AttributeDashMatch, // atom, value: the value or the value followed by '-'
+        AttributePrefix,    // atom, value
+        AttributeSuffix,    // atom, value
+        AttributeSubstring, // atom, value
+        NthChild,           // a, b: the position is a*n+b for some n >= 0
+        NthLastChild,
+        NthOfType,
+        NthLastOfType,
+        Empty,
+        Root,
+        Not,                // Fails if the next "value" instructions all pass
+        Parent,             // "A > B"
+        Ancestor,           // "A B"
+        PreviousSibling,    // "A + B"
+        AnyPreviousSibling  // "A ~ B"
+    };
+
+    struct Instruction
+    {
+        Op op = Op::Match;
+        AtomTable::Atom atom = AtomTable::None;
+        uint32_t value = 0;  // Index into values, the block length for Not
+        int32_t a = 0;
+        int32_t b = 0;
+    };
+
+    std::vector<Instruction> code {};
+    std::vector<std::string> values {};
+    std::vector<uint32_t> entries {};
+};
+
+#endif //DOMPARSER_SELECTORPROGRAM_H
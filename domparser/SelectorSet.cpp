@@ -0,0 +1,122 @@
+#include "SelectorSet.h"
+#include "SelectorCache.h"
+
+#include <stdexcept>
+
+SelectorSet::SelectorSet(const std::vector<std::string>& rules)
+{
+    std::unordered_map<std::string, uint32_t> distinct;
+
+    for (const auto& rule : rules)
+    {
+        auto found = distinct.find(rule);
+
+        if (found == distinct.end())
+        {
+            auto compiled = SelectorCache::getGlobal().get(rule);
+
+            if (compiled == nullptr)
+            {
+                throw std::logic_error("Rule is incorrect");
+            }
+            const uint32_t index = static_cast<uint32_t>(m_Rules.size());
+            found = distinct.emplace(rule, index).first;
+
+            // The attribute is usually the rarer key
+            if (compiled->getAttributeAtom() != AtomTable::None)
+            {
+                m_RulesByAttribute[compiled->getAttributeAtom()].push_back(index);
+            }
+            else if (compiled->getTagAtom() != AtomTable::None)
+            {
+                m_RulesByTag[compiled->getTagAtom()].push_back(index);
+            }
+            else
+            {
+                m_UnkeyedRules.push_back(index);
+            }
+            m_UsesAncestorFilter = m_UsesAncestorFilter || compiled->usesAncestorFilter();
+            m_Rules.push_back(std::move(compiled));
+        }
+        m_Selectors.push_back(found->second);
+    }
+}
+
+size_t SelectorSet::getSize() const
+{
+    return m_Selectors.size();
+}
+
+std::vector<std::vector<uint32_t>> SelectorSet::select(Document& document) const
+{
+    std::vector<std::vector<uint32_t>> matches(m_Rules.size());
+    // Last tag each rule was tested on, a tag may repeat an attribute
+    std::vector<uint32_t> tested(m_Rules.size(), Document::npos);
+    AncestorFilter filter;
+
+    for (uint32_t i = 0; i < document.getSize(); ++i)
+    {
+        Tag& tag = document.getNode(i);
+
+        if (tag.isRemoved())
+        {
+            continue;
+        }
+
+        if (m_UsesAncestorFilter)
+        {
+            filter.moveTo(tag);
+        }
+        evaluateHelper(m_UnkeyedRules, tag, filter, tested, matches);
+
+        const auto byTag = m_RulesByTag.find(tag.getTagAtom());
+
+        if (byTag != m_RulesByTag.end())
+        {
+            evaluateHelper(byTag->second, tag, filter, tested, matches);
+        }
+
+        if (!m_RulesByAttribute.empty())
+        {
+            for (size_t j = 0; j < tag.getAttributeCount(); ++j)
+            {
+                const auto byAttribute = m_RulesByAttribute.find(tag.getAttributeAtom(j));
+
+                if (byAttribute != m_RulesByAttribute.end())
+                {
+                    evaluateHelper(byAttribute->second, tag, filter, tested, matches);
+                }
+            }
+        }
+
+        if (m_UsesAncestorFilter)
+        {
+            filter.push(tag);
+        }
+    }
+    std::vector<std::vector<uint32_t>> result;
+    result.reserve(m_Selectors.size());
+
+    for (const auto rule : m_Selectors)
+    {
+        result.push_back(matches[rule]);
+    }
+    return result;
+}
+
+void SelectorSet::evaluateHelper(const Rules& rules, Tag& tag, const AncestorFilter& filter, std::vector<uint32_t>& tested,
+                                 std::vector<std::vector<uint32_t>>& matches) const
+{
+    for (const auto rule : rules)
+    {
+        if (tested[rule] != tag.getIndex())
+        {
+            tested[rule] = tag.getIndex();
+
+            if (m_Rules[rule]->checkRules(&tag, filter))
+            {
+                matches[rule].push_back(tag.getIndex());
+            }
+        }
+    }
+}
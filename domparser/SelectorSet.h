@@ -0,0 +1,42 @@
+#ifndef DOMPARSER_SELECTORSET_H
+#define DOMPARSER_SELECTORSET_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CheckRulesFactory.h"
+#include "Document.h"
+
+// Several rules evaluated in one pass over a parsed document. Rules with the
+// same text are compiled and evaluated once. A tag is tested only against the
+// rules keyed by its name or by one of its attributes, and the rules without a key.
+class SelectorSet
+{
+public:
+    // Throws std::logic_error if one of the rules is incorrect
+    explicit SelectorSet(const std::vector<std::string>&);
+    ~SelectorSet() = default;
+
+    // Number of rules as given, repeated ones included
+    size_t getSize() const;
+    // Indices of the matching tags in document order, one list per rule in the given order
+    std::vector<std::vector<uint32_t>> select(Document&) const;
+
+private:
+    using Rules = std::vector<uint32_t>;
+
+    void evaluateHelper(const Rules&, Tag&, const AncestorFilter&, std::vector<uint32_t>&, std::vector<std::vector<uint32_t>>&) const;
+
+private:
+    std::vector<std::shared_ptr<const CheckRulesFactory>> m_Rules {}; // Distinct rules
+    std::vector<uint32_t> m_Selectors {}; // The distinct rule of every given rule
+    std::unordered_map<AtomTable::Atom, Rules> m_RulesByTag {};
+    std::unordered_map<AtomTable::Atom, Rules> m_RulesByAttribute {};
+    Rules m_UnkeyedRules {};
+    bool m_UsesAncestorFilter = false;
+};
+
+#endif //DOMPARSER_SELECTORSET_H
@@ -0,0 +1,68 @@
+#include "SourceString.h"
+
+SourceString::SourceString(const std::string& str)
+: m_Storage(str.empty() ? nullptr : new std::string(str))
+{
+
+}
+
+void SourceString::assign(const std::string& str)
+{
+    if (m_Storage)
+    {
+        m_Storage->assign(str);
+    }
+    else
+    {
+        m_Storage.reset(new std::string(str));
+    }
+    m_View = StringSpan();
+    m_Owned = true;
+}
+
+void SourceString::setView(const StringSpan& span)
+{
+    m_Storage.reset();
+    m_View = span;
+    m_Owned = false;
+}
+
+StringSpan SourceString::getView() const
+{
+    if (!m_Owned)
+    {
+        return m_View;
+    }
+    // Owned characters may have been changed through materialize(), so the view is not cached
+    return m_Storage ? StringSpan(*m_Storage) : StringSpan();
+}
+
+std::string SourceString::str() const
+{
+    return getView().str();
+}
+
+std::string& SourceString::materialize()
+{
+    if (!m_Storage)
+    {
+        m_Storage.reset(new std::string());
+    }
+    if (!m_Owned)
+    {
+        m_Storage->assign(m_View.data(), m_View.size());
+        m_View = StringSpan();
+        m_Owned = true;
+    }
+    return *m_Storage;
+}
+
+bool SourceString::isView() const
+{
+    return !m_Owned;
+}
+
+bool SourceString::empty() const
+{
+    return getView().empty();
+}
@@ -0,0 +1,38 @@
+#ifndef DOMPARSER_SOURCESTRING_H
+#define DOMPARSER_SOURCESTRING_H
+
+#include <string>
+
+#include "CopyablePtr.h"
+#include "StringSpan.h"
+
+// String that either points into the retained page source or owns its
+// characters. Parsed values stay views, a value is copied only when it is
+// changed or handed out for modification. Owned characters are kept out of
+// line, so a view costs no more than a span and a pointer.
+class SourceString
+{
+public:
+    SourceString() = default;
+    SourceString(const std::string&);
+
+    void assign(const std::string&);
+    void setView(const StringSpan&);
+    StringSpan getView() const;
+    std::string str() const;
+    std::string& materialize();
+    bool isView() const;
+    bool empty() const;
+
+private:
+    StringSpan m_View {};
+    CopyablePtr<std::string> m_Storage {};
+    bool m_Owned = true;
+};
+
+inline bool operator==(const SourceString& left, const SourceString& right)
+{
+    return left.getView() == right.getView();
+}
+
+#endif //DOMPARSER_SOURCESTRING_H
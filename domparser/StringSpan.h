@@ -0,0 +1,80 @@
+#ifndef DOMPARSER_STRINGSPAN_H
+#define DOMPARSER_STRINGSPAN_H
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+// Non-owning view of characters, the buffer must outlive the span
+class StringSpan
+{
+public:
+    StringSpan() = default;
+    StringSpan(const char* data, size_t size)
+    : m_Data(data),
+      m_Size(size)
+    {}
+    StringSpan(const char* data)
+    : m_Data(data),
+      m_Size(std::strlen(data))
+    {}
+    StringSpan(const std::string& str)
+    : m_Data(str.data()),
+      m_Size(str.size())
+    {}
+
+    const char* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    char operator[](size_t index) const { return m_Data[index]; }
+    std::string str() const { return std::string(m_Data, m_Size); }
+
+    bool startsWith(const StringSpan& prefix) const
+    {
+        return prefix.m_Size <= m_Size && std::memcmp(m_Data, prefix.m_Data, prefix.m_Size) == 0;
+    }
+
+    bool endsWith(const StringSpan& suffix) const
+    {
+        return suffix.m_Size <= m_Size && std::memcmp(m_Data + m_Size - suffix.m_Size, suffix.m_Data, suffix.m_Size) == 0;
+    }
+
+    bool contains(const StringSpan& part) const
+    {
+        if (part.m_Size == 0)
+        {
+            return true;
+        }
+
+        for (size_t i = 0; i + part.m_Size <= m_Size; ++i)
+        {
+            if (m_Data[i] == part.m_Data[0] && std::memcmp(m_Data + i, part.m_Data, part.m_Size) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const char* m_Data = "";
+    size_t m_Size = 0;
+};
+
+inline bool operator==(const StringSpan& left, const StringSpan& right)
+{
+    return left.size() == right.size() && std::memcmp(left.data(), right.data(), left.size()) == 0;
+}
+
+inline bool operator!=(const StringSpan& left, const StringSpan& right)
+{
+    return !(left == right);
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const StringSpan& span)
+{
+    return stream.write(span.data(), static_cast<std::streamsize>(span.size()));
+}
+
+#endif //DOMPARSER_STRINGSPAN_H
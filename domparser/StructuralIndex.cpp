@@ -0,0 +1,233 @@
+#include "StructuralIndex.h"
+
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DOMPARSER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(DOMPARSER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DOMPARSER_TARGET(name) __attribute__((target(name)))
+#else
+#define DOMPARSER_TARGET(name)
+#endif
+
+namespace
+{
+    struct StructuralTable
+    {
+        bool value[256] {};
+
+        StructuralTable()
+        {
+            for (auto c : {'<', '>', '"', '\'', '=', '&', '/'})
+            {
+                value[static_cast<unsigned char>(c)] = true;
+            }
+        }
+    };
+
+    const StructuralTable structuralTable;
+
+    unsigned countTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    void appendMask(std::vector<uint32_t>& positions, uint32_t mask, size_t offset)
+    {
+        while (mask != 0)
+        {
+            positions.emplace_back(static_cast<uint32_t>(offset + countTrailingZeros(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+    size_t buildScalar(const char* data, size_t begin, size_t size, std::vector<uint32_t>& positions)
+    {
+        for (size_t i = begin; i < size; ++i)
+        {
+            if (structuralTable.value[static_cast<unsigned char>(data[i])])
+            {
+                positions.emplace_back(static_cast<uint32_t>(i));
+            }
+        }
+        return size;
+    }
+
+#if defined(DOMPARSER_X86)
+    DOMPARSER_TARGET("sse2")
+    size_t buildSSE2(const char* data, size_t size, std::vector<uint32_t>& positions)
+    {
+        const __m128i lt = _mm_set1_epi8('<');
+        const __m128i gt = _mm_set1_epi8('>');
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i apostrophe = _mm_set1_epi8('\'');
+        const __m128i equal = _mm_set1_epi8('=');
+        const __m128i ampersand = _mm_set1_epi8('&');
+        const __m128i slash = _mm_set1_epi8('/');
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i match = _mm_or_si128(_mm_cmpeq_epi8(block, lt), _mm_cmpeq_epi8(block, gt));
+            match = _mm_or_si128(match, _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, apostrophe)));
+            match = _mm_or_si128(match, _mm_or_si128(_mm_cmpeq_epi8(block, equal), _mm_cmpeq_epi8(block, ampersand)));
+            match = _mm_or_si128(match, _mm_cmpeq_epi8(block, slash));
+            appendMask(positions, static_cast<uint32_t>(_mm_movemask_epi8(match)), i);
+        }
+        return i;
+    }
+
+    DOMPARSER_TARGET("avx2")
+    size_t buildAVX2(const char* data, size_t size, std::vector<uint32_t>& positions)
+    {
+        const __m256i lt = _mm256_set1_epi8('<');
+        const __m256i gt = _mm256_set1_epi8('>');
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i apostrophe = _mm256_set1_epi8('\'');
+        const __m256i equal = _mm256_set1_epi8('=');
+        const __m256i ampersand = _mm256_set1_epi8('&');
+        const __m256i slash = _mm256_set1_epi8('/');
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(block, lt), _mm256_cmpeq_epi8(block, gt));
+            match = _mm256_or_si256(match, _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, apostrophe)));
+            match = _mm256_or_si256(match, _mm256_or_si256(_mm256_cmpeq_epi8(block, equal), _mm256_cmpeq_epi8(block, ampersand)));
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi8(block, slash));
+            appendMask(positions, static_cast<uint32_t>(_mm256_movemask_epi8(match)), i);
+        }
+        return i;
+    }
+
+    bool cpuSupports(StructuralIndex::Implementation implementation)
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        if (implementation == StructuralIndex::Implementation::SSE2)
+        {
+            return (info[3] & (1 << 26)) != 0;
+        }
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        if (implementation == StructuralIndex::Implementation::SSE2)
+        {
+            return __builtin_cpu_supports("sse2");
+        }
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
+
+bool StructuralIndex::isSupported(Implementation implementation)
+{
+    if (implementation == Implementation::Scalar)
+    {
+        return true;
+    }
+#if defined(DOMPARSER_X86)
+    return cpuSupports(implementation);
+#else
+    return false;
+#endif
+}
+
+StructuralIndex::Implementation StructuralIndex::getBestImplementation()
+{
+    static const Implementation best = isSupported(Implementation::AVX2) ? Implementation::AVX2
+                                     : isSupported(Implementation::SSE2) ? Implementation::SSE2
+                                     : Implementation::Scalar;
+    return best;
+}
+
+bool StructuralIndex::isStructural(char c)
+{
+    return structuralTable.value[static_cast<unsigned char>(c)];
+}
+
+bool StructuralIndex::build(const char* data, size_t size)
+{
+    return build(data, size, getBestImplementation());
+}
+
+bool StructuralIndex::build(const char* data, size_t size, Implementation implementation)
+{
+    clear();
+
+    if (size > std::numeric_limits<uint32_t>::max() || !isSupported(implementation))
+    {
+        return false;
+    }
+    m_Data = data;
+    m_Size = size;
+    // Markup has roughly one delimiter per eight bytes
+    m_Positions.reserve(size / 8 + 16);
+
+    size_t processed = 0;
+#if defined(DOMPARSER_X86)
+    if (implementation == Implementation::AVX2)
+    {
+        processed = buildAVX2(data, size, m_Positions);
+    }
+    else if (implementation == Implementation::SSE2)
+    {
+        processed = buildSSE2(data, size, m_Positions);
+    }
+#endif
+    buildScalar(data, processed, size, m_Positions);
+    return true;
+}
+
+const std::vector<uint32_t>& StructuralIndex::getPositions() const
+{
+    return m_Positions;
+}
+
+size_t StructuralIndex::find(char c, size_t from)
+{
+    // Lookups only move forward, so the cursor never has to go back
+    while (m_Cursor < m_Positions.size() && m_Positions[m_Cursor] < from)
+    {
+        ++m_Cursor;
+    }
+
+    for (size_t i = m_Cursor; i < m_Positions.size(); ++i)
+    {
+        if (m_Data[m_Positions[i]] == c)
+        {
+            return m_Positions[i];
+        }
+    }
+    return m_Size;
+}
+
+void StructuralIndex::clear()
+{
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Cursor = 0;
+    m_Positions.clear();
+}
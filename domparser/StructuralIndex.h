@@ -0,0 +1,44 @@
+#ifndef DOMPARSER_STRUCTURALINDEX_H
+#define DOMPARSER_STRUCTURALINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stage one of the parser: a vectorized scan that records the offset of every
+// markup delimiter ('<', '>', '"', '\'', '=', '&', '/'). The tokenizer then jumps
+// from delimiter to delimiter instead of testing each byte.
+class StructuralIndex
+{
+public:
+    enum class Implementation
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+public:
+    StructuralIndex() = default;
+    ~StructuralIndex() = default;
+
+    // Uses the fastest implementation the CPU supports
+    bool build(const char*, size_t);
+    bool build(const char*, size_t, Implementation);
+
+    const std::vector<uint32_t>& getPositions() const;
+    size_t find(char, size_t);
+    void clear();
+
+    static bool isSupported(Implementation);
+    static Implementation getBestImplementation();
+    static bool isStructural(char);
+
+private:
+    const char* m_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Cursor = 0;
+    std::vector<uint32_t> m_Positions {};
+};
+
+#endif //DOMPARSER_STRUCTURALINDEX_H
@@ -1,54 +1,202 @@
 #include "Tag.h"
+#include "Document.h"
+#include "Tokenizer.h"
 
 Tag::Tag(const std::string& tegName)
 	: m_Name(tegName),
+      m_NameAtom(AtomTable::getGlobal().find(tegName)),
       m_Parent(nullptr)
 {
 
 }
 
-Tag::~Tag()
+Tag::Tag(Arena* arena)
+	: m_Arena(arena),
+      m_Parent(nullptr),
+      m_AttributeTag(ArenaAllocator<SourceString>(arena)),
+      m_AttributeValueTag(ArenaAllocator<SourceString>(arena)),
+      m_AttributeAtoms(ArenaAllocator<AtomTable::Atom>(arena))
 {
-    m_Parent = nullptr;
+
 }
 
 bool Tag::operator==(Tag* right)
 {
-	return m_Name == right->m_Name && m_Parent == right->m_Parent
-		   && m_Content == right->m_Content && m_AttributeTag == right->m_AttributeTag
-		   && m_AttributeValueTag == right->m_AttributeValueTag;
+	return m_Name == right->m_Name && getParent() == right->getParent()
+		   && m_Content == right->m_Content && equalAttributes(*right);
 }
 
 bool Tag::operator==(const Tag& right)
 {
-    return m_Name == right.m_Name && m_Parent == right.m_Parent
-           && m_Content == right.m_Content && m_AttributeTag == right.m_AttributeTag
-           && m_AttributeValueTag == right.m_AttributeValueTag;
+    return m_Name == right.m_Name && getParent() == right.getParent()
+           && m_Content == right.m_Content && equalAttributes(right);
+}
+
+bool Tag::equalAttributes(const Tag& right) const
+{
+	if (getAttributeCount() != right.getAttributeCount() || getAttributeValueCount() != right.getAttributeValueCount())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < getAttributeCount(); ++i)
+	{
+		if (getAttributeName(i) != right.getAttributeName(i))
+		{
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < getAttributeValueCount(); ++i)
+	{
+		if (getAttributeValue(i) != right.getAttributeValue(i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void Tag::assignHelper(SourceString& target, const std::string& value)
+{
+	if (m_Arena != nullptr)
+	{
+		target.setView(m_Arena->copy(value));
+		return;
+	}
+	target.assign(value);
 }
 
 void Tag::setTagName(const std::string& tagName)
 {
-	m_Name = tagName;
+	assignHelper(m_Name, tagName);
+	m_NameAtom = AtomTable::getGlobal().find(tagName);
 }
 
 std::string Tag::getTagName() const
 {
-	return m_Name;
+	return m_Name.str();
+}
+
+void Tag::setTagNameView(const StringSpan& tagName)
+{
+	m_Name.setView(tagName);
+	m_NameAtom = AtomTable::getGlobal().find(tagName);
+}
+
+StringSpan Tag::getTagNameView() const
+{
+	return m_Name.getView();
+}
+
+bool Tag::hasTagName(KnownName name) const
+{
+	return m_NameAtom == static_cast<AtomTable::Atom>(name);
+}
+
+bool Tag::hasSameTagName(const Tag& right) const
+{
+	const AtomTable::Atom atom = getTagAtom();
+
+	if (atom != AtomTable::None || right.getTagAtom() != AtomTable::None)
+	{
+		return atom == right.getTagAtom();
+	}
+	// Neither name is in the table, so the atoms tell nothing
+	return m_Name == right.m_Name;
+}
+
+void Tag::resolveAtoms() const
+{
+	const AtomTable& table = AtomTable::getGlobal();
+	m_AtomGeneration = table.getGeneration();
+
+	if (m_NameAtom == AtomTable::None)
+	{
+		m_NameAtom = table.find(m_Name.getView());
+	}
+
+	for (size_t i = 0; i < m_AttributeAtoms.size(); ++i)
+	{
+		if (m_AttributeAtoms[i] == AtomTable::None)
+		{
+			m_AttributeAtoms[i] = table.find(m_AttributeTag[i].getView());
+		}
+	}
 }
 
 void Tag::setContent(const std::string& constentValue)
 {
-	m_Content = constentValue;
+	assignHelper(m_Content, constentValue);
+	m_HasText = !constentValue.empty();
+	// It no longer matches the source
+	m_OuterHtml = StringSpan();
+}
+
+void Tag::setContentView(const StringSpan& contentValue)
+{
+	m_Content.setView(contentValue);
 }
 
 std::string Tag::getContent() const
 {
-	return m_Content;
+	return m_Content.str();
 }
 
 std::string& Tag::getContent()
 {
-	return m_Content;
+	m_OuterHtml = StringSpan();
+	return m_Content.materialize();
+}
+
+void Tag::setOuterHtmlView(const StringSpan& outerHtml)
+{
+	m_OuterHtml = outerHtml;
+}
+
+StringSpan Tag::getOuterHtmlView() const
+{
+	return m_OuterHtml;
+}
+
+std::string Tag::getText() const
+{
+	const StringSpan content = getContentView();
+	const char* position = content.data();
+	const char* end = content.data() + content.size();
+	std::string result;
+
+	if (m_Document != nullptr)
+	{
+		// The children are cut out of the content where their markup lies within it
+		for (uint32_t i = m_FirstChild; i != Document::npos; i = m_Document->getNode(i).m_NextSibling)
+		{
+			const StringSpan outerHtml = m_Document->getNode(i).getOuterHtmlView();
+
+			if (!outerHtml.empty() && outerHtml.data() >= position && outerHtml.data() + outerHtml.size() <= end)
+			{
+				result.append(position, outerHtml.data());
+				position = outerHtml.data() + outerHtml.size();
+			}
+		}
+	}
+	result.append(position, end);
+	return result;
+}
+
+StringSpan Tag::getContentView() const
+{
+	return m_Content.getView();
+}
+
+void Tag::setHasText(bool hasText)
+{
+	m_HasText = hasText;
+}
+
+bool Tag::hasText() const
+{
+	return m_HasText;
 }
 
 void Tag::setParent(Tag* ptr)
@@ -58,45 +206,310 @@ void Tag::setParent(Tag* ptr)
 
 Tag* Tag::getParent() const
 {
+	if (m_Document != nullptr)
+	{
+		return m_ParentIndex == Document::npos ? nullptr : &m_Document->getNode(m_ParentIndex);
+	}
 	return m_Parent;
 }
 
 void Tag::setChildren(Tag* ptr)
 {
-	m_Childrens.emplace_back(ptr);
+	if (ptr == nullptr)
+	{
+		return;
+	}
+	ptr->setParent(this);
+
+	if (m_Document == nullptr)
+	{
+		if (!m_Children)
+		{
+			m_Children.reset(new std::vector<Tag*>());
+		}
+		m_Children->push_back(ptr);
+	}
 }
 
 std::vector<Tag*> Tag::getChildren() const
 {
-	return m_Childrens;
+	std::vector<Tag*> result;
+	if (m_Document != nullptr)
+	{
+		for (uint32_t i = m_FirstChild; i != Document::npos; i = m_Document->getNode(i).m_NextSibling)
+		{
+			result.emplace_back(&m_Document->getNode(i));
+		}
+	}
+	else if (m_Children)
+	{
+		result = *m_Children;
+	}
+	return result;
+}
+
+const Document* Tag::getDocument() const
+{
+	return m_Document;
+}
+
+uint32_t Tag::getIndex() const
+{
+	return m_Index;
+}
+
+uint32_t Tag::getParentIndex() const
+{
+	return m_ParentIndex;
+}
+
+uint32_t Tag::getFirstChildIndex() const
+{
+	return m_FirstChild;
+}
+
+uint32_t Tag::getNextSiblingIndex() const
+{
+	return m_NextSibling;
+}
+
+uint32_t Tag::getPreviousSiblingIndex() const
+{
+	return m_PreviousSibling;
+}
+
+uint32_t Tag::getSubtreeEnd() const
+{
+	return m_SubtreeEnd;
+}
+
+void Tag::setOwner(const std::shared_ptr<const void>& owner)
+{
+	m_Owner = owner;
 }
 
 void Tag::setAttributeTag(const std::string &data)
 {
-    m_AttributeTag.emplace_back(data);
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		m_AttributeStrings->names.emplace_back(data);
+		return;
+	}
+	m_AttributeTag.emplace_back();
+	assignHelper(m_AttributeTag.back(), data);
+	m_AttributeAtoms.emplace_back(AtomTable::getGlobal().find(data));
 }
 
 std::vector<std::string> Tag::getAttributeTag() const
 {
-    return m_AttributeTag;
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		return m_AttributeStrings->names;
+	}
+
+	std::vector<std::string> result;
+	result.reserve(m_AttributeTag.size());
+	for (const auto& i : m_AttributeTag)
+	{
+		result.emplace_back(i.str());
+	}
+	return result;
 }
 
 std::vector<std::string>& Tag::getAttributeTag()
 {
-	return m_AttributeTag;
+	materializeAttributes();
+	return m_AttributeStrings->names;
 }
 
 void Tag::setAttributeValueTag(const std::string &data)
 {
-    m_AttributeValueTag.emplace_back(data);
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		m_AttributeStrings->values.emplace_back(data);
+		return;
+	}
+	m_AttributeValueTag.emplace_back();
+	assignHelper(m_AttributeValueTag.back(), data);
 }
 
 std::vector<std::string> Tag::getAttributeValueTag() const
 {
-    return m_AttributeValueTag;
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		return m_AttributeStrings->values;
+	}
+
+	std::vector<std::string> result;
+	result.reserve(m_AttributeValueTag.size());
+	for (const auto& i : m_AttributeValueTag)
+	{
+		result.emplace_back(i.str());
+	}
+	return result;
 }
 
 std::vector<std::string>& Tag::getAttributeValueTag()
 {
-	return m_AttributeValueTag;
-}
\ No newline at end of file
+	materializeAttributes();
+	return m_AttributeStrings->values;
+}
+
+void Tag::setAttributeView(const StringSpan& name, const StringSpan& value)
+{
+	parseAttributes();
+	appendAttributeHelper(name, value);
+}
+
+void Tag::setUnparsedAttributesView(const StringSpan& attributes)
+{
+	parseAttributes();
+	m_UnparsedAttributes = attributes;
+}
+
+void Tag::parseAttributesHelper() const
+{
+	// Reused by every tag, lexing does not allocate once it has grown
+	static thread_local std::vector<Tokenizer::Attribute> attributes;
+	const StringSpan source = m_UnparsedAttributes;
+	m_UnparsedAttributes = StringSpan();
+	Tokenizer::lexAttributes(source.data(), source.size(), attributes);
+
+	for (const auto& i : attributes)
+	{
+		appendAttributeHelper(StringSpan(source.data() + i.nameBegin, i.nameEnd - i.nameBegin),
+							  StringSpan(source.data() + i.valueBegin, i.valueEnd - i.valueBegin));
+	}
+}
+
+void Tag::appendAttributeHelper(const StringSpan& name, const StringSpan& value) const
+{
+	if (m_AttributeStrings)
+	{
+		m_AttributeStrings->names.emplace_back(name.str());
+		m_AttributeStrings->values.emplace_back(value.str());
+		return;
+	}
+	m_AttributeTag.emplace_back();
+	m_AttributeTag.back().setView(name);
+	m_AttributeAtoms.emplace_back(AtomTable::getGlobal().find(name));
+	m_AttributeValueTag.emplace_back();
+	m_AttributeValueTag.back().setView(value);
+}
+
+size_t Tag::getAttributeCount() const
+{
+	parseAttributes();
+	return m_AttributeStrings ? m_AttributeStrings->names.size() : m_AttributeTag.size();
+}
+
+StringSpan Tag::getAttributeName(size_t index) const
+{
+	parseAttributes();
+	return m_AttributeStrings ? StringSpan(m_AttributeStrings->names[index]) : m_AttributeTag[index].getView();
+}
+
+size_t Tag::getAttributeValueCount() const
+{
+	parseAttributes();
+	return m_AttributeStrings ? m_AttributeStrings->values.size() : m_AttributeValueTag.size();
+}
+
+StringSpan Tag::getAttributeValue(size_t index) const
+{
+	parseAttributes();
+	return m_AttributeStrings ? StringSpan(m_AttributeStrings->values[index]) : m_AttributeValueTag[index].getView();
+}
+
+AtomTable::Atom Tag::getAttributeAtom(size_t index) const
+{
+	parseAttributes();
+	// The string vectors can be changed through references, so their atoms are looked up
+	if (m_AttributeStrings)
+	{
+		return AtomTable::getGlobal().find(m_AttributeStrings->names[index]);
+	}
+
+	if (m_AttributeAtoms[index] == AtomTable::None && m_AtomGeneration != AtomTable::getGlobal().getGeneration())
+	{
+		resolveAtoms();
+	}
+	return m_AttributeAtoms[index];
+}
+
+size_t Tag::findAttribute(AtomTable::Atom atom) const
+{
+	if (atom != AtomTable::None)
+	{
+		for (size_t i = 0; i < getAttributeCount(); ++i)
+		{
+			if (getAttributeAtom(i) == atom)
+			{
+				return i;
+			}
+		}
+	}
+	return std::string::npos;
+}
+
+void Tag::replaceAttribute(size_t index, const std::string& name, const std::string& value)
+{
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		m_AttributeStrings->names[index] = name;
+		m_AttributeStrings->values[index] = value;
+		return;
+	}
+	assignHelper(m_AttributeTag[index], name);
+	assignHelper(m_AttributeValueTag[index], value);
+	m_AttributeAtoms[index] = AtomTable::getGlobal().find(name);
+}
+
+void Tag::eraseAttribute(size_t index)
+{
+	parseAttributes();
+
+	if (m_AttributeStrings)
+	{
+		m_AttributeStrings->names.erase(m_AttributeStrings->names.begin() + index);
+		m_AttributeStrings->values.erase(m_AttributeStrings->values.begin() + index);
+		return;
+	}
+	m_AttributeTag.erase(m_AttributeTag.begin() + index);
+	m_AttributeValueTag.erase(m_AttributeValueTag.begin() + index);
+	m_AttributeAtoms.erase(m_AttributeAtoms.begin() + index);
+}
+
+void Tag::clearAttributes()
+{
+	m_UnparsedAttributes = StringSpan();
+	m_AttributeTag.clear();
+	m_AttributeValueTag.clear();
+	m_AttributeAtoms.clear();
+	m_AttributeStrings.reset();
+}
+
+void Tag::materializeAttributes()
+{
+	if (m_AttributeStrings)
+	{
+		return;
+	}
+	AttributeStrings* strings = new AttributeStrings();
+	strings->names = static_cast<const Tag*>(this)->getAttributeTag();
+	strings->values = static_cast<const Tag*>(this)->getAttributeValueTag();
+	m_AttributeTag.clear();
+	m_AttributeValueTag.clear();
+	m_AttributeAtoms.clear();
+	m_AttributeStrings.reset(strings);
+}
@@ -1,27 +1,106 @@
 #ifndef DOMPARSER_TAG_H
 #define DOMPARSER_TAG_H
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "Arena.h"
+#include "ArenaAllocator.h"
+#include "AtomTable.h"
+#include "CopyablePtr.h"
+#include "SourceString.h"
+
+class Document;
+
 class Tag
 {
 public:
 	Tag(const std::string& = "");
-	~Tag();
+	// Attributes and copied strings are allocated in the document arena
+	explicit Tag(Arena*);
 
 	bool operator==(Tag*);
 	bool operator==(const Tag&);
 
 	void setTagName(const std::string&);
 	std::string getTagName() const;
+	// The view setters keep a reference into the page source instead of a copy
+	void setTagNameView(const StringSpan&);
+	StringSpan getTagNameView() const;
+	// Id of the name in the global atom table, None if no rule has interned the name
+	AtomTable::Atom getTagAtom() const;
+	bool hasTagName(KnownName) const;
+	bool hasSameTagName(const Tag&) const;
 
+	// Tags of a parsed document are linked by the Document, these link tags created outside of one
 	void setParent(Tag*);
 	Tag* getParent() const;
 
+	// Appends a child to a tag outside of a document and makes the tag its parent. The children
+	// of a document tag are those the Document links, getChildren() returns these.
 	void setChildren(Tag*);
 	std::vector<Tag*> getChildren() const;
 
+	// Position in the node table of the document, Document::npos when there is none
+	const Document* getDocument() const;
+	uint32_t getIndex() const;
+	uint32_t getParentIndex() const;
+	uint32_t getFirstChildIndex() const;
+	uint32_t getNextSiblingIndex() const;
+	uint32_t getPreviousSiblingIndex() const;
+	// One past the last descendant, the subtree is [getIndex(), getSubtreeEnd())
+	uint32_t getSubtreeEnd() const;
+	// Removed from the document, the tag is no longer linked and is skipped by queries
+	bool isRemoved() const;
+	// Keeps alive what the views and the document links of a copy refer to, see ProcessPage
+	void setOwner(const std::shared_ptr<const void>&);
+
+	// An attribute read in place, the value is empty when the attribute has none
+	struct Attribute
+	{
+		StringSpan name;
+		StringSpan value;
+		AtomTable::Atom atom;
+	};
+
+	class AttributeIterator
+	{
+	public:
+		AttributeIterator(const Tag* tag, size_t index)
+		: m_Tag(tag),
+		  m_Index(index)
+		{}
+
+		Attribute operator*() const;
+		AttributeIterator& operator++() { ++m_Index; return *this; }
+		bool operator!=(const AttributeIterator& right) const { return m_Index != right.m_Index; }
+
+	private:
+		const Tag* m_Tag;
+		size_t m_Index;
+	};
+
+	class AttributeRange
+	{
+	public:
+		explicit AttributeRange(const Tag* tag)
+		: m_Tag(tag)
+		{}
+
+		AttributeIterator begin() const { return AttributeIterator(m_Tag, 0); }
+		AttributeIterator end() const { return AttributeIterator(m_Tag, m_Tag->getAttributeCount()); }
+		size_t size() const { return m_Tag->getAttributeCount(); }
+
+	private:
+		const Tag* m_Tag;
+	};
+
+	// Iterates over the attributes without copying them, rules should read attributes this way
+	AttributeRange getAttributes() const;
+
 	void setAttributeTag(const std::string &);
+	// The const overloads return copies of the attributes
 	std::vector<std::string> getAttributeTag() const;
 	std::vector<std::string>& getAttributeTag();
 
@@ -29,19 +108,122 @@ public:
 	std::vector<std::string> getAttributeValueTag() const;
 	std::vector<std::string>& getAttributeValueTag();
 
+	void setAttributeView(const StringSpan&, const StringSpan&);
+	// The text of the start tag after its name, lexed into attributes the first time they are used.
+	// The first read, even through a const Tag, lexes them into the tag: until the attributes
+	// were read once, a tag with unparsed attributes must not be read from several threads.
+	void setUnparsedAttributesView(const StringSpan&);
+	size_t getAttributeCount() const;
+	StringSpan getAttributeName(size_t) const;
+	size_t getAttributeValueCount() const;
+	StringSpan getAttributeValue(size_t) const;
+	AtomTable::Atom getAttributeAtom(size_t) const;
+	// Index of the first attribute with the name, std::string::npos if there is none
+	size_t findAttribute(AtomTable::Atom) const;
+	void replaceAttribute(size_t, const std::string&, const std::string&);
+	void eraseAttribute(size_t);
+	void clearAttributes();
+
+	// The content is the inner markup of the element, a view into the page source once parsed
 	void setContent(const std::string&);
+	void setContentView(const StringSpan&);
 	std::string getContent() const;
 	std::string& getContent();
+	StringSpan getContentView() const;
+	// The element from its start tag to its end tag, a view into the page source. Empty for
+	// tags not parsed from a page.
+	void setOuterHtmlView(const StringSpan&);
+	StringSpan getOuterHtmlView() const;
+	// The text directly inside the element: its content without the markup of its children
+	std::string getText() const;
+	// Whether text, whitespace included, lies directly inside the element, comments are not
+	// text. Set by the builders of a document and by setContent(), ":empty" reads it.
+	void setHasText(bool);
+	bool hasText() const;
+
+private:
+	struct AttributeStrings
+	{
+		std::vector<std::string> names {};
+		std::vector<std::string> values {};
+	};
+
+	// The mutable vector accessors need real strings, so the attributes are copied once on first use
+	void materializeAttributes();
+	void parseAttributes() const;
+	void parseAttributesHelper() const;
+	void resolveAtoms() const;
+	void appendAttributeHelper(const StringSpan&, const StringSpan&) const;
+	bool equalAttributes(const Tag&) const;
+	void assignHelper(SourceString&, const std::string&);
 
 private:
-	std::string m_Name {};
+	friend class Document;
+
+	Arena* m_Arena = nullptr;
+	Document* m_Document = nullptr;
+	uint32_t m_Index = UINT32_MAX;
+	uint32_t m_ParentIndex = UINT32_MAX;
+	uint32_t m_FirstChild = UINT32_MAX;
+	uint32_t m_NextSibling = UINT32_MAX;
+	uint32_t m_PreviousSibling = UINT32_MAX;
+	uint32_t m_SubtreeEnd = UINT32_MAX;
+	SourceString m_Name {};
+	// Names are looked up, not interned. A name that was not in the table is
+	// looked up again once the table has changed since m_AtomGeneration.
+	mutable AtomTable::Atom m_NameAtom = AtomTable::None;
+	mutable uint32_t m_AtomGeneration = 0;
 	Tag* m_Parent;
-	std::string m_Content {};
-	std::vector<Tag*> m_Childrens {};
-	std::vector<std::string> m_AttributeTag {};
-	std::vector<std::string> m_AttributeValueTag {};
+	SourceString m_Content {};
+	StringSpan m_OuterHtml {};
+	// The attributes are filled from m_UnparsedAttributes on first read, so they are mutable
+	mutable StringSpan m_UnparsedAttributes {};
+	mutable std::vector<SourceString, ArenaAllocator<SourceString>> m_AttributeTag;
+	mutable std::vector<SourceString, ArenaAllocator<SourceString>> m_AttributeValueTag;
+	mutable std::vector<AtomTable::Atom, ArenaAllocator<AtomTable::Atom>> m_AttributeAtoms; // Parallel to m_AttributeTag
+	// Set once the attributes were handed out as std::string vectors, rare, so it is kept out of the node
+	CopyablePtr<AttributeStrings> m_AttributeStrings {};
+	CopyablePtr<std::vector<Tag*>> m_Children {}; // Of a tag outside of a document, which is rare
+	bool m_Removed = false;
+	bool m_HasText = false;
+	std::shared_ptr<const void> m_Owner {}; // Set on copies only, the tags of a document have none
 };
 
+// Read for every tag of a traversal, so they are inlined into the loops of the rules
+inline AtomTable::Atom Tag::getTagAtom() const
+{
+	if (m_NameAtom == AtomTable::None && m_AtomGeneration != AtomTable::getGlobal().getGeneration())
+	{
+		resolveAtoms();
+	}
+	return m_NameAtom;
+}
+
+inline bool Tag::isRemoved() const
+{
+	return m_Removed;
+}
+
+inline void Tag::parseAttributes() const
+{
+	if (!m_UnparsedAttributes.empty())
+	{
+		parseAttributesHelper();
+	}
+}
+
+inline Tag::Attribute Tag::AttributeIterator::operator*() const
+{
+	return {m_Tag->getAttributeName(m_Index),
+			m_Index < m_Tag->getAttributeValueCount() ? m_Tag->getAttributeValue(m_Index) : StringSpan(),
+			m_Tag->getAttributeAtom(m_Index)};
+}
+
+inline Tag::AttributeRange Tag::getAttributes() const
+{
+	return AttributeRange(this);
+}
+
 #endif //DOMPARSER_TAG_H
 
 
@@ -0,0 +1,645 @@
+#include "Tokenizer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f';
+    }
+
+    bool isNameStart(char c)
+    {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool equalsIgnoreCase(const char* left, const char* right, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(left[i])) != std::tolower(static_cast<unsigned char>(right[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char* const voidElements[] = {
+        "area", "base", "br", "col", "embed", "hr", "img", "input",
+        "link", "meta", "param", "source", "track", "wbr"
+    };
+}
+
+Tokenizer::Tokenizer(const char* data, size_t size, StructuralIndex* index)
+: m_Data(data),
+  m_Size(size),
+  m_Index(index)
+{
+
+}
+
+size_t Tokenizer::findNext(char c, size_t position)
+{
+    if (position >= m_Size)
+    {
+        return m_Size;
+    }
+
+    if (m_Index != nullptr)
+    {
+        return m_Index->find(c, position);
+    }
+    auto found = static_cast<const char*>(std::memchr(m_Data + position, c, m_Size - position));
+    return found == nullptr ? m_Size : static_cast<size_t>(found - m_Data);
+}
+
+void Tokenizer::setSkipAttributes(bool skip)
+{
+    m_SkipAttributes = skip;
+}
+
+void Tokenizer::setInput(const char* data, size_t size, bool final)
+{
+    m_Data = data;
+    m_Size = size;
+    m_Final = final;
+}
+
+size_t Tokenizer::getRetainOffset() const
+{
+    return m_TextBegin;
+}
+
+void Tokenizer::discard(size_t count)
+{
+    auto rebase = [count](size_t& value)
+    {
+        value = value < count ? 0 : value - count;
+    };
+
+    rebase(m_Position);
+    rebase(m_TextBegin);
+    rebase(m_TagBegin);
+    rebase(m_Token.begin);
+    rebase(m_Token.end);
+    rebase(m_Token.nameBegin);
+    rebase(m_Token.nameEnd);
+
+    for (auto& i : m_Token.attributes)
+    {
+        rebase(i.nameBegin);
+        rebase(i.nameEnd);
+        rebase(i.valueBegin);
+        rebase(i.valueEnd);
+    }
+}
+
+bool Tokenizer::isVoidElement(const char* name, size_t size)
+{
+    for (const auto& i : voidElements)
+    {
+        if (std::strlen(i) == size && equalsIgnoreCase(name, i, size))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tokenizer::lexAttributes(const char* data, size_t size, std::vector<Attribute>& attributes)
+{
+    Tokenizer tokenizer(data, size);
+    // Not final, the end of the data is not text
+    tokenizer.m_Final = false;
+    tokenizer.m_State = State::BeforeAttributeName;
+    tokenizer.m_Token.type = TokenType::StartTag;
+    attributes.clear();
+    // The caller's buffer keeps its capacity
+    tokenizer.m_Token.attributes.swap(attributes);
+
+    Token token;
+    if (tokenizer.next(token))
+    {
+        attributes.swap(token.attributes);
+        return;
+    }
+
+    // The data ends inside the last attribute
+    auto& pending = tokenizer.m_Token.attributes;
+    switch (tokenizer.m_State)
+    {
+        case State::AttributeName:
+            pending.back().nameEnd = pending.back().valueBegin = size;
+            pending.back().valueEnd = size;
+            break;
+        case State::AttributeValueDoubleQuoted:
+        case State::AttributeValueSingleQuoted:
+        case State::AttributeValueUnquoted:
+            pending.back().valueEnd = size;
+            break;
+        default:
+            break;
+    }
+    attributes.swap(pending);
+}
+
+bool Tokenizer::startsWith(size_t position, const char* str) const
+{
+    const size_t length = std::strlen(str);
+    return position + length <= m_Size && std::memcmp(m_Data + position, str, length) == 0;
+}
+
+bool Tokenizer::emitText(Token& token, size_t begin, size_t end)
+{
+    if (begin >= end)
+    {
+        return false;
+    }
+    token.type = TokenType::Text;
+    token.begin = begin;
+    token.end = end;
+    token.nameBegin = begin;
+    token.nameEnd = end;
+    token.selfClosing = false;
+    token.attributes.clear();
+    return true;
+}
+
+void Tokenizer::emitTag(Token& token)
+{
+    token.type = m_Token.type;
+    token.begin = m_Token.begin;
+    token.end = m_Token.end;
+    token.nameBegin = m_Token.nameBegin;
+    token.nameEnd = m_Token.nameEnd;
+    token.selfClosing = m_Token.selfClosing;
+    // Swap instead of copy so both attribute buffers keep their capacity
+    token.attributes.swap(m_Token.attributes);
+}
+
+void Tokenizer::beginRawTextIfNeeded(const Token& token)
+{
+    const size_t length = token.nameEnd - token.nameBegin;
+    const char* name = m_Data + token.nameBegin;
+
+    if (token.type == TokenType::StartTag && !token.selfClosing &&
+        ((length == 6 && equalsIgnoreCase(name, "script", 6)) || (length == 5 && equalsIgnoreCase(name, "style", 5))))
+    {
+        m_RawTextName.assign(name, length);
+        m_State = State::RawText;
+    }
+}
+
+bool Tokenizer::next(Token& token)
+{
+    while (m_Position < m_Size)
+    {
+        const char c = m_Data[m_Position];
+
+        switch (m_State)
+        {
+            case State::Data:
+            {
+                m_TagBegin = findNext('<', m_Position);
+                if (m_TagBegin >= m_Size)
+                {
+                    m_Position = m_Size;
+                    break;
+                }
+                m_Position = m_TagBegin + 1;
+                m_State = State::TagOpen;
+                break;
+            }
+            case State::TagOpen:
+            {
+                if (c != '!' && c != '/' && c != '?' && !isNameStart(c))
+                {
+                    // A lone '<' is part of the text
+                    m_State = State::Data;
+                    break;
+                }
+                if (emitText(token, m_TextBegin, m_TagBegin))
+                {
+                    m_TextBegin = m_TagBegin;
+                    return true;
+                }
+                ++m_Position;
+                if (c == '!')
+                {
+                    m_State = State::MarkupDeclarationOpen;
+                }
+                else if (c == '/')
+                {
+                    m_State = State::EndTagOpen;
+                }
+                else if (c == '?')
+                {
+                    m_State = State::BogusComment;
+                }
+                else
+                {
+                    m_Token.type = TokenType::StartTag;
+                    m_Token.begin = m_TagBegin;
+                    m_Token.nameBegin = m_Position - 1;
+                    m_Token.selfClosing = false;
+                    m_Token.attributes.clear();
+                    m_State = State::TagName;
+                }
+                break;
+            }
+            case State::EndTagOpen:
+            {
+                if (isNameStart(c))
+                {
+                    m_Token.type = TokenType::EndTag;
+                    m_Token.begin = m_TagBegin;
+                    m_Token.nameBegin = m_Position;
+                    m_Token.selfClosing = false;
+                    m_Token.attributes.clear();
+                    m_State = State::EndTagName;
+                }
+                else if (c == '>')
+                {
+                    ++m_Position;
+                    m_TextBegin = m_Position;
+                    m_State = State::Data;
+                }
+                else
+                {
+                    m_State = State::BogusComment;
+                }
+                break;
+            }
+            case State::TagName:
+            case State::EndTagName:
+            {
+                if (isSpace(c) || c == '/' || c == '>')
+                {
+                    m_Token.nameEnd = m_Position;
+                    if (m_State == State::EndTagName)
+                    {
+                        m_State = State::AfterEndTagName;
+                    }
+                    else if (m_SkipAttributes)
+                    {
+                        m_SkipName = false;
+                        m_SkipSlash = false;
+                        m_State = State::SkipAttributes;
+                    }
+                    else
+                    {
+                        m_State = State::BeforeAttributeName;
+                    }
+                    break;
+                }
+                ++m_Position;
+                break;
+            }
+            case State::AfterEndTagName:
+            {
+                ++m_Position;
+                if (c == '>')
+                {
+                    m_Token.end = m_Position;
+                    m_TextBegin = m_Position;
+                    m_State = State::Data;
+                    emitTag(token);
+                    return true;
+                }
+                break;
+            }
+            case State::BeforeAttributeName:
+            case State::AfterAttributeName:
+            {
+                if (isSpace(c))
+                {
+                    ++m_Position;
+                }
+                else if (c == '/')
+                {
+                    ++m_Position;
+                    m_State = State::SelfClosingStartTag;
+                }
+                else if (c == '>')
+                {
+                    ++m_Position;
+                    m_Token.end = m_Position;
+                    m_TextBegin = m_Position;
+                    m_State = State::Data;
+                    emitTag(token);
+                    beginRawTextIfNeeded(token);
+                    return true;
+                }
+                else if (c == '=' && m_State == State::AfterAttributeName)
+                {
+                    ++m_Position;
+                    m_State = State::BeforeAttributeValue;
+                }
+                else
+                {
+                    Attribute attribute;
+                    attribute.nameBegin = m_Position;
+                    attribute.valueBegin = attribute.valueEnd = m_Position;
+                    m_Token.attributes.emplace_back(attribute);
+                    ++m_Position;
+                    m_State = State::AttributeName;
+                }
+                break;
+            }
+            case State::AttributeName:
+            {
+                if (isSpace(c) || c == '/' || c == '>' || c == '=')
+                {
+                    auto& attribute = m_Token.attributes.back();
+                    attribute.nameEnd = attribute.valueBegin = attribute.valueEnd = m_Position;
+                    if (c == '=')
+                    {
+                        ++m_Position;
+                        m_State = State::BeforeAttributeValue;
+                    }
+                    else
+                    {
+                        m_State = State::AfterAttributeName;
+                    }
+                    break;
+                }
+                ++m_Position;
+                break;
+            }
+            case State::BeforeAttributeValue:
+            {
+                auto& attribute = m_Token.attributes.back();
+                if (isSpace(c))
+                {
+                    ++m_Position;
+                }
+                else if (c == '"' || c == '\'')
+                {
+                    ++m_Position;
+                    attribute.valueBegin = attribute.valueEnd = m_Position;
+                    m_State = c == '"' ? State::AttributeValueDoubleQuoted : State::AttributeValueSingleQuoted;
+                }
+                else if (c == '>')
+                {
+                    m_State = State::BeforeAttributeName;
+                }
+                else
+                {
+                    attribute.valueBegin = m_Position;
+                    m_State = State::AttributeValueUnquoted;
+                }
+                break;
+            }
+            case State::AttributeValueDoubleQuoted:
+            case State::AttributeValueSingleQuoted:
+            {
+                const char quote = m_State == State::AttributeValueDoubleQuoted ? '"' : '\'';
+                m_Position = findNext(quote, m_Position);
+                if (m_Position >= m_Size)
+                {
+                    break;
+                }
+                m_Token.attributes.back().valueEnd = m_Position;
+                ++m_Position;
+                m_State = State::BeforeAttributeName;
+                break;
+            }
+            case State::AttributeValueUnquoted:
+            {
+                if (isSpace(c) || c == '>')
+                {
+                    m_Token.attributes.back().valueEnd = m_Position;
+                    m_State = State::BeforeAttributeName;
+                    break;
+                }
+                ++m_Position;
+                break;
+            }
+            case State::SelfClosingStartTag:
+            {
+                if (c == '>')
+                {
+                    m_Token.selfClosing = true;
+                }
+                m_State = State::BeforeAttributeName;
+                break;
+            }
+            case State::SkipAttributes:
+            {
+                // Names and spaces are passed over in one loop, the state only changes at a value
+                while (m_Position < m_Size && m_State == State::SkipAttributes)
+                {
+                    const char current = m_Data[m_Position];
+
+                    if (current == '>')
+                    {
+                        break;
+                    }
+                    ++m_Position;
+
+                    if (current == '/')
+                    {
+                        m_SkipName = false;
+                        m_SkipSlash = true;
+                    }
+                    else if (current == '=' && m_SkipName)
+                    {
+                        m_SkipSlash = false;
+                        m_State = State::SkipBeforeAttributeValue;
+                    }
+                    else
+                    {
+                        m_SkipName = m_SkipName || !isSpace(current);
+                        m_SkipSlash = false;
+                    }
+                }
+
+                if (m_Position < m_Size && m_State == State::SkipAttributes)
+                {
+                    ++m_Position;
+                    m_Token.end = m_Position;
+                    m_Token.selfClosing = m_SkipSlash;
+                    m_TextBegin = m_Position;
+                    m_State = State::Data;
+                    emitTag(token);
+                    beginRawTextIfNeeded(token);
+                    return true;
+                }
+                break;
+            }
+            case State::SkipBeforeAttributeValue:
+            {
+                if (isSpace(c))
+                {
+                    ++m_Position;
+                }
+                else if (c == '"' || c == '\'')
+                {
+                    ++m_Position;
+                    m_SkipQuote = c;
+                    m_State = State::SkipAttributeValueQuoted;
+                }
+                else
+                {
+                    // A '>' ends the tag without a value
+                    m_SkipName = false;
+                    m_State = c == '>' ? State::SkipAttributes : State::SkipAttributeValueUnquoted;
+                }
+                break;
+            }
+            case State::SkipAttributeValueQuoted:
+            {
+                m_Position = findNext(m_SkipQuote, m_Position);
+                if (m_Position >= m_Size)
+                {
+                    break;
+                }
+                ++m_Position;
+                m_SkipName = false;
+                m_State = State::SkipAttributes;
+                break;
+            }
+            case State::SkipAttributeValueUnquoted:
+            {
+                if (isSpace(c) || c == '>')
+                {
+                    m_State = State::SkipAttributes;
+                    break;
+                }
+                ++m_Position;
+                break;
+            }
+            case State::MarkupDeclarationOpen:
+            {
+                if (!m_Final && m_Size - m_Position < 7)
+                {
+                    // Not enough input yet to tell a comment from CDATA or a doctype
+                    return false;
+                }
+
+                if (startsWith(m_Position, "--"))
+                {
+                    m_Position += 2;
+                    m_Token.nameBegin = m_Position;
+                    m_State = State::Comment;
+                }
+                else if (startsWith(m_Position, "[CDATA["))
+                {
+                    m_Position += 7;
+                    m_Token.nameBegin = m_Position;
+                    m_State = State::CData;
+                }
+                else
+                {
+                    m_State = State::BogusComment;
+                }
+                break;
+            }
+            case State::Comment:
+            case State::CData:
+            {
+                // Both terminators end with '>', which is a structural delimiter
+                const char* terminator = m_State == State::Comment ? "-->" : "]]>";
+                size_t position = findNext('>', std::max(m_Position, m_Token.nameBegin + 2));
+                while (position < m_Size && !startsWith(position - 2, terminator))
+                {
+                    position = findNext('>', position + 1);
+                }
+                if (position >= m_Size)
+                {
+                    m_Position = m_Size;
+                    break;
+                }
+                position -= 2;
+                token.type = m_State == State::Comment ? TokenType::Comment : TokenType::Text;
+                token.begin = m_TagBegin;
+                token.nameBegin = m_Token.nameBegin;
+                token.nameEnd = position;
+                token.end = position + 3;
+                token.selfClosing = false;
+                token.attributes.clear();
+                m_Position = token.end;
+                m_TextBegin = m_Position;
+                m_State = State::Data;
+                return true;
+            }
+            case State::BogusComment:
+            {
+                // Doctype, processing instructions and malformed markup are skipped
+                const size_t position = findNext('>', m_Position);
+                if (position >= m_Size && !m_Final)
+                {
+                    // The rest of it is in the next chunk
+                    m_Position = m_Size;
+                    break;
+                }
+                m_Position = std::min(position + 1, m_Size);
+                m_TextBegin = m_Position;
+                m_State = State::Data;
+                break;
+            }
+            case State::RawText:
+            {
+                const size_t length = m_RawTextName.size();
+                size_t position = findNext('<', m_Position);
+
+                while (position < m_Size)
+                {
+                    const size_t afterName = position + 2 + length;
+                    if (afterName >= m_Size && !m_Final)
+                    {
+                        // The end tag may continue in the next chunk
+                        m_Position = position;
+                        return false;
+                    }
+
+                    if (afterName < m_Size && m_Data[position + 1] == '/' &&
+                        equalsIgnoreCase(m_Data + position + 2, m_RawTextName.data(), length) &&
+                        (isSpace(m_Data[afterName]) || m_Data[afterName] == '>' || m_Data[afterName] == '/'))
+                    {
+                        break;
+                    }
+                    position = findNext('<', position + 1);
+                }
+
+                if (position >= m_Size)
+                {
+                    m_Position = m_Size;
+                    break;
+                }
+                m_TagBegin = position;
+                m_Position = m_TagBegin + 1;
+                m_State = State::TagOpen;
+                break;
+            }
+        }
+    }
+
+    if (!m_Final)
+    {
+        return false;
+    }
+
+    if (m_State == State::Comment && m_TextBegin < m_Size)
+    {
+        token.type = TokenType::Comment;
+        token.begin = m_TagBegin;
+        token.nameBegin = m_Token.nameBegin;
+        token.nameEnd = token.end = m_Size;
+        token.selfClosing = false;
+        token.attributes.clear();
+        m_TextBegin = m_Size;
+        return true;
+    }
+
+    if (emitText(token, m_TextBegin, m_Size))
+    {
+        m_TextBegin = m_Size;
+        return true;
+    }
+    return false;
+}
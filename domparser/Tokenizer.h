@@ -0,0 +1,117 @@
+#ifndef DOMPARSER_TOKENIZER_H
+#define DOMPARSER_TOKENIZER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "StructuralIndex.h"
+
+// Single-pass state machine over the markup. Every byte is visited once,
+// tokens refer to the input by offsets and nothing is copied.
+class Tokenizer
+{
+public:
+    enum class TokenType
+    {
+        StartTag,
+        EndTag,
+        Text,
+        Comment
+    };
+
+    struct Attribute
+    {
+        size_t nameBegin = 0;
+        size_t nameEnd = 0;
+        size_t valueBegin = 0;
+        size_t valueEnd = 0;
+    };
+
+    struct Token
+    {
+        TokenType type = TokenType::Text;
+        size_t begin = 0;       // First byte of the token ('<' for tags)
+        size_t end = 0;         // One past the last byte ('>' included for tags)
+        size_t nameBegin = 0;   // Tag name or text/comment body
+        size_t nameEnd = 0;
+        bool selfClosing = false;
+        std::vector<Attribute> attributes {};
+    };
+
+public:
+    // The structural index is optional, without it delimiters are found with memchr
+    Tokenizer(const char*, size_t, StructuralIndex* = nullptr);
+    ~Tokenizer() = default;
+
+    // Returns false at the end of the input, or when more input is needed
+    bool next(Token&);
+    // Start tags are only scanned to their '>', quoted values included, and their attributes are
+    // left empty: the attribute text is the bytes from nameEnd to the '>', for lexAttributes()
+    void setSkipAttributes(bool);
+
+    // Push mode: the input grows in chunks and is final only after the last one.
+    // The buffer may move between calls but must keep its bytes from the retain offset on.
+    void setInput(const char*, size_t, bool);
+    size_t getRetainOffset() const;
+    // Drops the given number of leading bytes, which are no longer needed
+    void discard(size_t);
+    // Elements such as <br> or <img> that never have an end tag
+    static bool isVoidElement(const char*, size_t);
+    // Lexes the attributes of a start tag, given from after its name up to the '>', in the
+    // same pass as next() does. Offsets are relative to the given data.
+    static void lexAttributes(const char*, size_t, std::vector<Attribute>&);
+
+private:
+    enum class State
+    {
+        Data,
+        TagOpen,
+        EndTagOpen,
+        TagName,
+        EndTagName,
+        AfterEndTagName,
+        BeforeAttributeName,
+        AttributeName,
+        AfterAttributeName,
+        BeforeAttributeValue,
+        AttributeValueDoubleQuoted,
+        AttributeValueSingleQuoted,
+        AttributeValueUnquoted,
+        SelfClosingStartTag,
+        // setSkipAttributes(): the same boundaries as the attribute states, nothing is recorded
+        SkipAttributes,
+        SkipBeforeAttributeValue,
+        SkipAttributeValueQuoted,
+        SkipAttributeValueUnquoted,
+        MarkupDeclarationOpen,
+        Comment,
+        CData,
+        BogusComment,
+        RawText
+    };
+
+    bool emitText(Token&, size_t, size_t);
+    void emitTag(Token&);
+    void beginRawTextIfNeeded(const Token&);
+    bool startsWith(size_t, const char*) const;
+    size_t findNext(char, size_t);
+
+private:
+    const char* m_Data;
+    size_t m_Size;
+    StructuralIndex* m_Index;
+    bool m_Final = true;
+    size_t m_Position = 0;
+    size_t m_TextBegin = 0;
+    size_t m_TagBegin = 0;
+    State m_State = State::Data;
+    bool m_SkipAttributes = false;
+    bool m_SkipName = false;  // An attribute name came last, a '=' starts its value
+    bool m_SkipSlash = false; // A '/' came last, the tag is self-closing if '>' follows
+    char m_SkipQuote = '"';
+    Token m_Token {};
+    std::string m_RawTextName {};
+};
+
+#endif //DOMPARSER_TOKENIZER_H
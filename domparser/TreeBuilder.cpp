@@ -0,0 +1,366 @@
+#include "TreeBuilder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+}
+
+TreeBuilder::TreeBuilder(Document& document, Observer* observer)
+: m_Document(document),
+  m_Observer(observer)
+{
+
+}
+
+TreeBuilder::~TreeBuilder()
+{
+    ::operator delete(m_Markup);
+}
+
+void TreeBuilder::setLazyAttributes(bool lazy)
+{
+    m_LazyAttributes = lazy;
+}
+
+void TreeBuilder::setRegions(const CheckRulesFactory* rule)
+{
+    m_Regions = rule != nullptr && rule->hasRegions() ? rule : nullptr;
+}
+
+void TreeBuilder::build(const char* data, size_t size)
+{
+    m_OpenElements.clear();
+    m_OpenNames.clear();
+    m_ClosedElements.clear();
+    setInput(data, 0);
+    m_Views = true;
+    m_Stopped = false;
+
+    // The index is built over the whole input, which an observer may not need to read
+    const bool indexed = m_Observer == nullptr && m_Index.build(data, size);
+    Tokenizer tokenizer(data, size, indexed ? &m_Index : nullptr);
+    tokenizer.setSkipAttributes(m_LazyAttributes);
+    Tokenizer::Token token;
+    size_t end = size;
+
+    while (tokenizer.next(token))
+    {
+        handleToken(token);
+
+        if (m_Stopped)
+        {
+            end = token.end;
+            break;
+        }
+    }
+    finish(end);
+    m_Index.clear();
+    m_Views = false;
+}
+
+void TreeBuilder::setInput(const char* data, size_t offset)
+{
+    m_Data = data;
+    m_Offset = offset;
+}
+
+void TreeBuilder::handleToken(const Tokenizer::Token& token)
+{
+    if (token.type == Tokenizer::TokenType::StartTag)
+    {
+        startTag(token);
+    }
+    else if (token.type == Tokenizer::TokenType::EndTag)
+    {
+        endTag(token);
+    }
+    else if (token.type == Tokenizer::TokenType::Text && !m_OpenElements.empty() &&
+             m_OpenElements.back().index != Document::npos)
+    {
+        m_Document.getNode(m_OpenElements.back().index).setHasText(true);
+    }
+}
+
+void TreeBuilder::finish(size_t size)
+{
+    while (!m_OpenElements.empty())
+    {
+        closeElement(size, size);
+    }
+    release(std::numeric_limits<size_t>::max());
+}
+
+void TreeBuilder::release(size_t offset)
+{
+    // The markup of the open elements is kept out of the window
+    const size_t open = m_OpenElements.empty() ? std::numeric_limits<size_t>::max() : m_OpenElements.front().tagBegin;
+
+    if (open < offset)
+    {
+        appendMarkupHelper(offset);
+    }
+
+    // An element either ended before the open ones began or lies inside one of them, so the
+    // elements before the offset come first. Their markup is copied in one piece, that of
+    // the others is copied with the open elements.
+    size_t count = 0;
+    size_t begin = std::numeric_limits<size_t>::max();
+    size_t end = 0;
+
+    while (count < m_ClosedElements.size() && m_ClosedElements[count].tagEnd <= offset &&
+           m_ClosedElements[count].tagBegin < open)
+    {
+        begin = std::min(begin, m_ClosedElements[count].tagBegin);
+        end = std::max(end, m_ClosedElements[count].tagEnd);
+        ++count;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+    const char* copy = m_Document.getArena().copy(StringSpan(m_Data + begin - m_Offset, end - begin)).data();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ClosedElement& element = m_ClosedElements[i];
+        Tag& tag = m_Document.getNode(element.index);
+        tag.setOuterHtmlView(StringSpan(copy + element.tagBegin - begin, element.tagEnd - element.tagBegin));
+
+        if (element.contentBegin != std::numeric_limits<size_t>::max())
+        {
+            tag.setContentView(StringSpan(copy + element.contentBegin - begin, element.contentEnd - element.contentBegin));
+        }
+    }
+    m_ClosedElements.erase(m_ClosedElements.begin(), m_ClosedElements.begin() + count);
+}
+
+void TreeBuilder::startTag(const Tokenizer::Token& token)
+{
+    const uint32_t parent = m_OpenElements.empty() ? Document::npos : m_OpenElements.back().index;
+    const bool isVoid = token.selfClosing || Tokenizer::isVoidElement(m_Data + token.nameBegin, token.nameEnd - token.nameBegin);
+
+    // Outside of the regions, only the spans of a whole document can be kept for the end tags
+    if (m_Regions != nullptr && m_Views && parent == Document::npos && !isRegionRootHelper(token))
+    {
+        if (!isVoid)
+        {
+            m_OpenElements.push_back({Document::npos, token.end + m_Offset, token.begin + m_Offset,
+                                      StringSpan(m_Data + token.nameBegin, token.nameEnd - token.nameBegin)});
+            m_OpenNames.add(m_OpenElements.back().name);
+        }
+        return;
+    }
+    const uint32_t index = m_Document.append(parent);
+    Tag* tag = &m_Document.getNode(index);
+    tag->setTagNameView(spanHelper(token.nameBegin, token.nameEnd));
+
+    if (m_LazyAttributes && token.end - 1 > token.nameEnd)
+    {
+        // Up to the '>' that ends the token, the tokenizer has not lexed it
+        tag->setUnparsedAttributesView(spanHelper(token.nameEnd, token.end - 1));
+    }
+    else
+    {
+        for (const auto& i : token.attributes)
+        {
+            tag->setAttributeView(spanHelper(i.nameBegin, i.nameEnd), spanHelper(i.valueBegin, i.valueEnd));
+        }
+    }
+    m_Document.indexNode(index);
+
+    if (m_Observer != nullptr && !m_Stopped)
+    {
+        m_Stopped = !m_Observer->elementStarted(index);
+    }
+
+    if (!isVoid)
+    {
+        m_OpenElements.push_back({index, token.end + m_Offset, token.begin + m_Offset, StringSpan()});
+        m_OpenNames.add(tag->getTagNameView());
+        return;
+    }
+
+    if (m_Views)
+    {
+        tag->setOuterHtmlView(StringSpan(m_Data + token.begin, token.end - token.begin));
+    }
+    else
+    {
+        m_ClosedElements.push_back({index, token.begin + m_Offset, std::numeric_limits<size_t>::max(), 0,
+                                    token.end + m_Offset});
+    }
+
+    if (m_Observer != nullptr && !m_Stopped)
+    {
+        m_Stopped = !m_Observer->elementClosed(index);
+    }
+}
+
+void TreeBuilder::endTag(const Tokenizer::Token& token)
+{
+    const StringSpan name(m_Data + token.nameBegin, token.nameEnd - token.nameBegin);
+
+    // A stray end tag is dropped without walking the open elements
+    if (!m_OpenNames.contains(name))
+    {
+        return;
+    }
+
+    for (size_t i = m_OpenElements.size(); i > 0; --i)
+    {
+        const OpenElement& element = m_OpenElements[i - 1];
+
+        if ((element.index == Document::npos ? element.name : m_Document.getNode(element.index).getTagNameView()) == name)
+        {
+            // Elements left open inside the closed one end where its end tag begins
+            while (m_OpenElements.size() > i)
+            {
+                closeElement(token.begin + m_Offset, token.begin + m_Offset);
+            }
+            closeElement(token.begin + m_Offset, token.end + m_Offset);
+            return;
+        }
+    }
+}
+
+void TreeBuilder::closeElement(size_t contentEnd, size_t tagEnd)
+{
+    const OpenElement element = m_OpenElements.back();
+    const uint32_t index = element.index;
+    size_t contentBegin = element.contentBegin;
+    m_OpenElements.pop_back();
+
+    if (index == Document::npos)
+    {
+        m_OpenNames.remove(element.name);
+        return;
+    }
+    m_OpenNames.remove(m_Document.getNode(index).getTagNameView());
+
+    while (contentBegin < contentEnd && isSpace(byteHelper(contentBegin)))
+    {
+        ++contentBegin;
+    }
+
+    while (contentEnd > contentBegin && isSpace(byteHelper(contentEnd - 1)))
+    {
+        --contentEnd;
+    }
+
+    // A chunk is dropped once parsed, so the element is copied when its bytes leave the window
+    if (m_Views)
+    {
+        m_Document.getNode(index).setOuterHtmlView(StringSpan(m_Data + element.tagBegin, tagEnd - element.tagBegin));
+        m_Document.getNode(index).setContentView(StringSpan(m_Data + contentBegin, contentEnd - contentBegin));
+    }
+    else
+    {
+        m_ClosedElements.push_back({index, element.tagBegin, contentBegin, contentEnd, tagEnd});
+
+        if (m_OpenElements.empty() && m_MarkupSize != 0)
+        {
+            adoptMarkupHelper(tagEnd);
+        }
+    }
+    m_Document.close(index);
+
+    if (m_Observer != nullptr && !m_Stopped)
+    {
+        m_Stopped = !m_Observer->elementClosed(index);
+    }
+}
+
+bool TreeBuilder::isRegionRootHelper(const Tokenizer::Token& token)
+{
+    // The attributes are lexed again only if the rule reads them
+    m_RegionTag.setTagNameView(StringSpan(m_Data + token.nameBegin, token.nameEnd - token.nameBegin));
+    m_RegionTag.clearAttributes();
+
+    if (token.end - 1 > token.nameEnd)
+    {
+        m_RegionTag.setUnparsedAttributesView(StringSpan(m_Data + token.nameEnd, token.end - 1 - token.nameEnd));
+    }
+    return m_Regions->isRegionRoot(m_RegionTag);
+}
+
+StringSpan TreeBuilder::spanHelper(size_t begin, size_t end)
+{
+    const StringSpan span(m_Data + begin, end - begin);
+    return m_Views ? span : m_Document.getArena().copy(span);
+}
+
+char TreeBuilder::byteHelper(size_t offset) const
+{
+    return offset >= m_Offset ? m_Data[offset - m_Offset] : m_Markup[offset - m_MarkupBegin];
+}
+
+void TreeBuilder::appendMarkupHelper(size_t offset)
+{
+    if (m_MarkupSize == 0)
+    {
+        m_MarkupBegin = m_OpenElements.front().tagBegin;
+    }
+    const size_t begin = m_MarkupBegin + m_MarkupSize;
+
+    if (offset <= begin)
+    {
+        return;
+    }
+    const size_t size = offset - begin;
+
+    if (m_MarkupSize + size > m_MarkupCapacity)
+    {
+        // Grows by half, what the arena takes over is at most a third unused
+        const size_t capacity = std::max({m_MarkupSize + size, m_MarkupCapacity + m_MarkupCapacity / 2, size_t(4096)});
+        char* markup = static_cast<char*>(::operator new(capacity));
+
+        if (m_MarkupSize != 0)
+        {
+            std::memcpy(markup, m_Markup, m_MarkupSize);
+        }
+        ::operator delete(m_Markup);
+        m_Markup = markup;
+        m_MarkupCapacity = capacity;
+    }
+    std::memcpy(m_Markup + m_MarkupSize, m_Data + begin - m_Offset, size);
+    m_MarkupSize += size;
+}
+
+void TreeBuilder::adoptMarkupHelper(size_t offset)
+{
+    appendMarkupHelper(offset);
+    m_Document.getArena().adopt(m_Markup, m_MarkupCapacity, m_MarkupSize);
+
+    // The elements closed inside the markup come last, after those closed before it
+    size_t first = m_ClosedElements.size();
+
+    while (first > 0 && m_ClosedElements[first - 1].tagBegin >= m_MarkupBegin)
+    {
+        --first;
+    }
+
+    for (size_t i = first; i < m_ClosedElements.size(); ++i)
+    {
+        const ClosedElement& element = m_ClosedElements[i];
+        Tag& tag = m_Document.getNode(element.index);
+        tag.setOuterHtmlView(StringSpan(m_Markup + element.tagBegin - m_MarkupBegin, element.tagEnd - element.tagBegin));
+
+        if (element.contentBegin != std::numeric_limits<size_t>::max())
+        {
+            tag.setContentView(StringSpan(m_Markup + element.contentBegin - m_MarkupBegin, element.contentEnd - element.contentBegin));
+        }
+    }
+    m_ClosedElements.erase(m_ClosedElements.begin() + static_cast<std::ptrdiff_t>(first), m_ClosedElements.end());
+    m_Markup = nullptr;
+    m_MarkupSize = 0;
+    m_MarkupCapacity = 0;
+}
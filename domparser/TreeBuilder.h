@@ -0,0 +1,111 @@
+#ifndef DOMPARSER_TREEBUILDER_H
+#define DOMPARSER_TREEBUILDER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CheckRulesFactory.h"
+#include "Document.h"
+#include "OpenNameCounts.h"
+#include "StructuralIndex.h"
+#include "Tag.h"
+#include "Tokenizer.h"
+
+// Builds the whole tree in one forward pass over the Tokenizer output,
+// appending the tags to the document in document order.
+// A whole document given to build() must outlive the tags, which refer to it;
+// in incremental use the input is a temporary window and strings are copied
+// into the document arena. The markup of an element is copied once, when it
+// leaves the window, and nested elements share that copy: the markup of the
+// open elements is gathered in one buffer, which the arena takes over once the
+// outermost of them closes. The window only has to keep the token being read.
+class TreeBuilder
+{
+public:
+    // Told about every element of a build() as it starts and as it closes, void
+    // elements close right after they start. Returning false ends the build there:
+    // the elements still open are closed at that point and the rest is not read.
+    class Observer
+    {
+    public:
+        virtual ~Observer() = default;
+        virtual bool elementStarted(uint32_t) = 0;
+        virtual bool elementClosed(uint32_t) = 0;
+    };
+
+public:
+    explicit TreeBuilder(Document&, Observer* = nullptr);
+    ~TreeBuilder();
+
+    TreeBuilder(const TreeBuilder&) = delete;
+    TreeBuilder& operator=(const TreeBuilder&) = delete;
+
+    // Keeps the attribute text of each tag to be lexed when the attributes are first read
+    void setLazyAttributes(bool);
+    // build() then adds only the subtrees of the region roots of the rule, if it has regions. The
+    // other tags are only followed to match the end tags: a region's top tag has no parent.
+    void setRegions(const CheckRulesFactory*);
+    void build(const char*, size_t);
+
+    // Incremental use: the input is a window of the document starting at the given offset
+    void setInput(const char*, size_t);
+    void handleToken(const Tokenizer::Token&);
+    void finish(size_t);
+    // The window is about to drop the bytes before the offset, the elements there are copied
+    void release(size_t);
+
+private:
+    void startTag(const Tokenizer::Token&);
+    void endTag(const Tokenizer::Token&);
+    void closeElement(size_t, size_t);
+    bool isRegionRootHelper(const Tokenizer::Token&);
+    StringSpan spanHelper(size_t, size_t);
+    // The byte at the document offset, from the window or from the markup of the open elements
+    char byteHelper(size_t) const;
+    // Appends the bytes of the window up to the document offset to the markup of the open elements
+    void appendMarkupHelper(size_t);
+    // The outermost open element closed at the offset, the arena takes over the markup
+    void adoptMarkupHelper(size_t);
+
+private:
+    Document& m_Document;
+    Observer* m_Observer;
+    bool m_Stopped = false;
+    const char* m_Data = nullptr;
+    size_t m_Offset = 0;
+    bool m_Views = false;
+    bool m_LazyAttributes = false;
+    const CheckRulesFactory* m_Regions = nullptr;
+    Tag m_RegionTag {}; // The start tag a region root is looked for in
+    StructuralIndex m_Index {};
+    struct OpenElement
+    {
+        uint32_t index;      // Document::npos for a tag left out of the document
+        size_t contentBegin; // Document offsets
+        size_t tagBegin;
+        StringSpan name;     // Of a tag left out
+    };
+
+    std::vector<OpenElement> m_OpenElements {};
+    OpenNameCounts m_OpenNames {};
+    // Incremental use: elements closed but not yet copied, in the order they closed
+    struct ClosedElement
+    {
+        uint32_t index;
+        size_t tagBegin;     // Document offsets
+        size_t contentBegin; // npos for a void element
+        size_t contentEnd;
+        size_t tagEnd;
+    };
+
+    std::vector<ClosedElement> m_ClosedElements {};
+    // Incremental use: the markup of the open elements that left the window, from m_MarkupBegin on.
+    // Allocated with ::operator new, so that the arena can take it over without a copy.
+    char* m_Markup = nullptr;
+    size_t m_MarkupSize = 0;
+    size_t m_MarkupCapacity = 0;
+    size_t m_MarkupBegin = 0; // Document offset
+};
+
+#endif //DOMPARSER_TREEBUILDER_H
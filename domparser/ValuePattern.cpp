@@ -0,0 +1,47 @@
+#include "ValuePattern.h"
+
+ValuePattern::ValuePattern(const std::string& pattern)
+: m_Pattern(pattern)
+{
+
+}
+
+bool ValuePattern::matchesAt(const StringSpan& value, size_t position) const
+{
+    if (position + m_Pattern.size() > value.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_Pattern.size(); ++i)
+    {
+        const char c = value[position + i];
+        if (m_Pattern[i] == '.' ? (c == '\n' || c == '\r') : c != m_Pattern[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ValuePattern::isPrefixOf(const StringSpan& value) const
+{
+    return matchesAt(value, 0);
+}
+
+bool ValuePattern::isSuffixOf(const StringSpan& value) const
+{
+    return value.size() >= m_Pattern.size() && matchesAt(value, value.size() - m_Pattern.size());
+}
+
+bool ValuePattern::isPartOf(const StringSpan& value) const
+{
+    for (size_t i = 0; i + m_Pattern.size() <= value.size(); ++i)
+    {
+        if (matchesAt(value, i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
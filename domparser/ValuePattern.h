@@ -0,0 +1,27 @@
+#ifndef DOMPARSER_VALUEPATTERN_H
+#define DOMPARSER_VALUEPATTERN_H
+
+#include <string>
+
+#include "StringSpan.h"
+
+// Attribute value of a rule, compared in place. As in the regular expressions
+// the rules used to build, '.' stands for any character except a line break.
+class ValuePattern
+{
+public:
+    ValuePattern() = default;
+    explicit ValuePattern(const std::string&);
+
+    bool isPrefixOf(const StringSpan&) const;
+    bool isSuffixOf(const StringSpan&) const;
+    bool isPartOf(const StringSpan&) const;
+
+private:
+    bool matchesAt(const StringSpan&, size_t) const;
+
+private:
+    std::string m_Pattern {};
+};
+
+#endif //DOMPARSER_VALUEPATTERN_H
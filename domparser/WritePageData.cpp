@@ -23,30 +23,21 @@ void WritePageData::writeToFile()
     {
         throw std::logic_error("Page data is null");
     }
-    writeToFileHelper(m_PageData);
+    writeToFileHelper(m_PageData->current());
     m_FileOutput.close();
 }
 
-void WritePageData::writeToFileHelper(std::shared_ptr<IPageData> pageData)
+void WritePageData::writeToFileHelper(const Tag* currentTag)
 {
-    if (pageData->current() != nullptr)
+    if (currentTag != nullptr)
     {
-        auto currentTag = pageData->current();
-        std::string output("<" + currentTag->getTagName());
-        auto attributes = currentTag->getAttributeTag();
+        m_FileOutput << "<" << currentTag->getTagNameView();
 
-        if (!attributes.empty())
+        for (size_t i = 0; i < currentTag->getAttributeCount() && i < currentTag->getAttributeValueCount(); ++i)
         {
-            auto attributesValue = currentTag->getAttributeValueTag();
-
-            for (size_t i = 0; i < attributes.size() && i < attributesValue.size(); ++i)
-            {
-                std::string argument(" " + attributes[i] + "=\"" + attributesValue[i] + "\"");
-                output += argument;
-            }
+            m_FileOutput << " " << currentTag->getAttributeName(i) << "=\"" << currentTag->getAttributeValue(i) << "\"";
         }
-        output += ">\n";
-        m_FileOutput << output;
+        m_FileOutput << ">\n";
 
         auto children = currentTag->getChildren();
 
@@ -54,14 +45,13 @@ void WritePageData::writeToFileHelper(std::shared_ptr<IPageData> pageData)
         {
             for (const auto& i : children)
             {
-                m_PageData->next();
-                writeToFileHelper(m_PageData);
+                writeToFileHelper(i);
             }
         }
         else
         {
-            m_FileOutput << currentTag->getContent() << "\n";
+            m_FileOutput << currentTag->getContentView() << "\n";
         }
-        m_FileOutput << "</" << currentTag->getTagName() << ">\n";
+        m_FileOutput << "</" << currentTag->getTagNameView() << ">\n";
     }
 }
\ No newline at end of file
@@ -17,7 +17,8 @@ public:
     void writeToFile();
 
 private:
-    void writeToFileHelper(std::shared_ptr<IPageData>);
+    // Writes the tag and, in place of its content, its children if it has any
+    void writeToFileHelper(const Tag*);
 
 private:
     std::shared_ptr<IPageData> m_PageData;
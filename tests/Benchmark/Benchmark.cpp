@@ -0,0 +1,307 @@
+#include "domparser/AncestorFilter.h"
+#include "domparser/Arena.h"
+#include "domparser/CheckRulesFactory.h"
+#include "domparser/Document.h"
+#include "domparser/SelectorDsl.h"
+#include "domparser/TreeBuilder.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr char total[] = "total";
+    constexpr char prices[] = "prices";
+    constexpr char block[] = "block";
+
+    // Deep page: every block nests sections down to a table of cells, one block in ten has prices
+    std::string makePage(size_t blocks)
+    {
+        std::string page = "<html><body>";
+
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            page += "<div class=\"block\">";
+            for (int depth = 0; depth < 12; ++depth)
+            {
+                page += "<section><div>";
+            }
+            page += i % 10 == 0 ? "<table class=\"prices\">" : "<table class=\"other\">";
+            for (int row = 0; row < 4; ++row)
+            {
+                page += "<tr><td>1</td><td>2</td><td class=\"total\">3</td></tr>";
+            }
+            page += "</table>";
+            for (int depth = 0; depth < 12; ++depth)
+            {
+                page += "</div></section>";
+            }
+            page += "</div>";
+        }
+        page += "</body></html>";
+        return page;
+    }
+
+    // Flat page of tags with many attributes, as generated markup often has
+    std::string makeAttributePage(size_t blocks)
+    {
+        std::string page = "<html><body>";
+
+        for (size_t i = 0; i < blocks * 10; ++i)
+        {
+            page += "<div class=\"row item-" + std::to_string(i % 7) + "\" id=\"item" + std::to_string(i) + "\" data-id=\"" +
+                    std::to_string(i) + "\" data-kind=\"product\" style=\"color: red; margin: 0 auto\" title='a > b'>"
+                    "<a href=\"/items/" + std::to_string(i) + "?ref=list&amp;page=2\" rel=\"nofollow noopener\" target=_blank "
+                    "data-track=\"click\" aria-label=\"Open item\">link</a><img src=\"/img/" + std::to_string(i) +
+                    ".png\" alt=\"\" width=\"64\" height=\"64\" loading=lazy decoding=async></div>";
+        }
+        page += "</body></html>";
+        return page;
+    }
+
+    // Best of several runs, in nanoseconds per tag
+    double measure(Document& document, const std::function<size_t()>& run, size_t& matches)
+    {
+        double best = 0;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            matches = run();
+            const auto end = std::chrono::steady_clock::now();
+            const double time = std::chrono::duration<double, std::nano>(end - begin).count() / document.getSize();
+
+            if (i == 0 || time < best)
+            {
+                best = time;
+            }
+        }
+        return best;
+    }
+
+    void benchmarkAncestorFilter(Document& document, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        size_t plainMatches = 0;
+        size_t filteredMatches = 0;
+
+        const double plain = measure(document, [&]()
+        {
+            size_t count = 0;
+            for (auto& i : document.getNodes())
+            {
+                count += ptr->checkRules(&i) ? 1 : 0;
+            }
+            return count;
+        }, plainMatches);
+
+        const double filtered = measure(document, [&]()
+        {
+            // The library traversals keep the filter only for the rules that use it
+            if (!ptr->usesAncestorFilter())
+            {
+                size_t count = 0;
+                for (auto& i : document.getNodes())
+                {
+                    count += ptr->checkRules(&i) ? 1 : 0;
+                }
+                return count;
+            }
+            AncestorFilter filter;
+            size_t count = 0;
+            for (auto& i : document.getNodes())
+            {
+                filter.moveTo(i);
+                count += ptr->checkRules(&i, filter) ? 1 : 0;
+                filter.push(i);
+            }
+            return count;
+        }, filteredMatches);
+
+        std::cout << std::left << std::setw(28) << rule << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << plainMatches << " matches"
+                  << std::setw(10) << plain << " ns/tag plain"
+                  << std::setw(10) << filtered << " ns/tag with ancestor filter"
+                  << (plainMatches == filteredMatches ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // The loop of CheckRulesFactory, a virtual checkRules call per tag, against the one the rule instantiates for itself
+    void benchmarkStaticDispatch(Document& document, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        std::vector<uint32_t> indices;
+        size_t virtualMatches = 0;
+        size_t staticMatches = 0;
+
+        const double virtualCalls = measure(document, [&]()
+        {
+            indices.clear();
+            ptr->CheckRulesFactory::selectNodes(document, indices, SIZE_MAX);
+            return indices.size();
+        }, virtualMatches);
+
+        const double staticCalls = measure(document, [&]()
+        {
+            indices.clear();
+            ptr->selectNodes(document, indices, SIZE_MAX);
+            return indices.size();
+        }, staticMatches);
+
+        std::cout << std::left << std::setw(28) << rule << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << virtualMatches << " matches"
+                  << std::setw(10) << virtualCalls << " ns/tag virtual"
+                  << std::setw(10) << staticCalls << " ns/tag static"
+                  << (virtualMatches == staticMatches ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Building the page and running the rule, with the attributes lexed while building or on first read
+    void benchmarkLazyAttributes(Document& document, const std::string& page, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        size_t eagerMatches = 0;
+        size_t lazyMatches = 0;
+
+        auto run = [&](bool lazy)
+        {
+            Arena arena;
+            Document built(arena);
+            TreeBuilder builder(built);
+            builder.setLazyAttributes(lazy);
+            builder.build(page.data(), page.size());
+            std::vector<uint32_t> indices;
+            ptr->selectNodes(built, indices, SIZE_MAX);
+            return indices.size();
+        };
+
+        const double eager = measure(document, [&]() { return run(false); }, eagerMatches);
+        const double lazy = measure(document, [&]() { return run(true); }, lazyMatches);
+
+        std::cout << std::left << std::setw(28) << rule << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << eagerMatches << " matches"
+                  << std::setw(10) << eager << " ns/tag eager"
+                  << std::setw(10) << lazy << " ns/tag lazy attributes"
+                  << (eagerMatches == lazyMatches ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Building the whole page against building only the subtrees the rule can match in
+    void benchmarkSelectiveBuild(Document& document, const std::string& page, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        size_t fullMatches = 0;
+        size_t selectiveMatches = 0;
+        size_t built = 0;
+
+        auto run = [&](const CheckRulesFactory* regions)
+        {
+            Arena arena;
+            Document part(arena);
+            TreeBuilder builder(part);
+            builder.setRegions(regions);
+            builder.build(page.data(), page.size());
+            std::vector<uint32_t> indices;
+            ptr->selectNodes(part, indices, SIZE_MAX);
+            built = part.getSize();
+            return indices.size();
+        };
+
+        const double full = measure(document, [&]() { return run(nullptr); }, fullMatches);
+        const double selective = measure(document, [&]() { return run(ptr.get()); }, selectiveMatches);
+
+        std::cout << std::left << std::setw(28) << rule << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << fullMatches << " matches"
+                  << std::setw(10) << full << " ns/tag whole page"
+                  << std::setw(10) << selective << " ns/tag selective, "
+                  << built << " tags built"
+                  << (fullMatches == selectiveMatches ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // The rule compiled at run time, with its own loop, against the same selector written with the DSL
+    template <typename Selector>
+    void benchmarkSelectorDsl(Document& document, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        std::vector<uint32_t> indices;
+        size_t compiledMatches = 0;
+        size_t dslMatches = 0;
+
+        const double compiled = measure(document, [&]()
+        {
+            indices.clear();
+            ptr->selectNodes(document, indices, SIZE_MAX);
+            return indices.size();
+        }, compiledMatches);
+
+        const double dsl = measure(document, [&]()
+        {
+            indices.clear();
+            dom::selectNodes<Selector>(document, indices);
+            return indices.size();
+        }, dslMatches);
+
+        std::cout << std::left << std::setw(28) << rule << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << compiledMatches << " matches"
+                  << std::setw(10) << compiled << " ns/tag compiled"
+                  << std::setw(10) << dsl << " ns/tag dom::select"
+                  << (compiledMatches == dslMatches ? "" : "  MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // The first argument, when it is a number, scales the page
+    const size_t blocks = argc > 1 && std::atoi(argv[1]) > 0 ? static_cast<size_t>(std::atoi(argv[1])) : 500;
+    const std::string page = makePage(blocks);
+
+    Arena arena;
+    Document document(arena);
+    TreeBuilder(document).build(page.data(), page.size());
+    std::cout << document.getSize() << " tags" << std::endl;
+
+    for (const auto rule : {"table.prices td", "table.prices td.total", "body > div.block td", "section section table", "td"})
+    {
+        benchmarkAncestorFilter(document, rule);
+    }
+
+    for (const auto rule : {"*", "td", "[class]", "[class='total']", "tr > td", "td.total"})
+    {
+        benchmarkStaticDispatch(document, rule);
+    }
+
+    for (const auto rule : {"td", "table td", "td.total"})
+    {
+        benchmarkLazyAttributes(document, page, rule);
+    }
+
+    // The lazy build only scans the attributes to the end of the tag
+    const std::string attributePage = makeAttributePage(blocks);
+    Arena attributeArena;
+    Document attributeDocument(attributeArena);
+    TreeBuilder(attributeDocument).build(attributePage.data(), attributePage.size());
+    std::cout << attributeDocument.getSize() << " tags with many attributes" << std::endl;
+
+    for (const auto rule : {"a", "div a", "[data-id='42']"})
+    {
+        benchmarkLazyAttributes(attributeDocument, attributePage, rule);
+    }
+
+    for (const auto rule : {"table.prices td", "tr > td", "td.total", "div.block > section"})
+    {
+        benchmarkSelectiveBuild(document, page, rule);
+    }
+
+    using Td = dom::tag<KnownName::Td>;
+    benchmarkSelectorDsl<dom::select<Td, dom::hasClass<total>>>(document, "td.total");
+    benchmarkSelectorDsl<dom::select<dom::tag<KnownName::Tr>, dom::child, Td, dom::hasClass<total>>>(document, "tr > td.total");
+    benchmarkSelectorDsl<dom::select<dom::attr<KnownName::Class, total>>>(document, "[class='total']");
+    benchmarkSelectorDsl<dom::select<dom::tag<KnownName::Div>, dom::hasClass<block>, dom::child, dom::tag<KnownName::Section>>>(
+        document, "div.block > section");
+    benchmarkSelectorDsl<dom::select<dom::tag<KnownName::Table>, dom::hasClass<prices>, dom::descendant, Td>>(document, "table.prices td");
+    return 0;
+}
@@ -663,6 +663,85 @@ TEST(InterfaceRuleTest, SelectChildrenOfTheSpecificTag)
     EXPECT_EQ(pageData->last()->getTagName(), "p");
 }
 
+TEST(QuerySelectorTest, WholeDocument)
+{
+    std::unique_ptr<IDOMFactory> ptr(new PageDataFactory);
+    std::unique_ptr<IPageData> pageData(ptr->createPageData("index.html", "div"));
+
+    EXPECT_EQ(pageData->getNumberOfTags(), 1);
+    auto paragraphs = pageData->querySelectorAll("body > p");
+    ASSERT_EQ(paragraphs.size(), 2);
+    EXPECT_EQ(paragraphs[0]->getContent(), "Text");
+    EXPECT_EQ(paragraphs[1]->getContent(), "Another text");
+    EXPECT_EQ(paragraphs[0]->getParent(), pageData->querySelector("body"));
+
+    EXPECT_EQ(pageData->querySelector("p ~ i")->getTagName(), "i");
+    EXPECT_EQ(pageData->querySelector("ul"), nullptr);
+    EXPECT_EQ(pageData->querySelectorAll("*").size(), 10);
+    EXPECT_THROW(pageData->querySelectorAll("&"), std::logic_error);
+    EXPECT_EQ(pageData->getNumberOfTags(), 1);
+}
+
+TEST(QuerySelectorTest, IndexFollowsChanges)
+{
+    std::unique_ptr<IDOMFactory> ptr(new PageDataFactory);
+    std::unique_ptr<IPageData> pageData(ptr->createPageData("index.html", "p"));
+
+    EXPECT_EQ(pageData->querySelectorAll("#main").size(), 0);
+    EXPECT_TRUE(pageData->insertAttribute("id", "main"));
+    ASSERT_NE(pageData->querySelector("#main"), nullptr);
+    EXPECT_EQ(pageData->querySelector("#main")->getContent(), "Text");
+
+    EXPECT_TRUE(pageData->changeAttribute("id", "main", "class", "first para"));
+    EXPECT_EQ(pageData->querySelector("#main"), nullptr);
+    EXPECT_EQ(pageData->querySelectorAll("p.para").size(), 1);
+    EXPECT_EQ(pageData->querySelectorAll("[name]").size(), 3);
+
+    EXPECT_TRUE(pageData->removeAttribute("name", "nameP"));
+    EXPECT_EQ(pageData->querySelectorAll("[name]").size(), 2);
+
+    EXPECT_TRUE(pageData->removeTag());
+    EXPECT_EQ(pageData->querySelectorAll(".para").size(), 0);
+    EXPECT_EQ(pageData->querySelectorAll("p").size(), 1);
+    EXPECT_EQ(pageData->querySelectorAll("body > *").size(), 3);
+
+    Tag tag;
+    tag.setTagName("p");
+    tag.setAttributeTag("id");
+    tag.setAttributeValueTag("added");
+    pageData->pushBack(tag);
+    EXPECT_EQ(pageData->querySelectorAll("p").size(), 2);
+    EXPECT_EQ(pageData->querySelector("#added")->getTagName(), "p");
+}
+
+TEST(QuerySelectorTest, ResultsSurvivePushes)
+{
+    std::unique_ptr<IDOMFactory> ptr(new PageDataFactory);
+    std::unique_ptr<IPageData> pageData(ptr->createPageData("index.html", "p"));
+
+    Tag* body = pageData->querySelector("body");
+    auto paragraphs = pageData->querySelectorAll("p");
+    Tag* parent = pageData->parent();
+    ASSERT_NE(body, nullptr);
+    ASSERT_EQ(paragraphs.size(), 2);
+
+    // Well past the first growth of the node table
+    Tag tag;
+    tag.setTagName("span");
+    for (int i = 0; i < 2000; ++i)
+    {
+        pageData->pushBack(tag);
+    }
+    EXPECT_EQ(pageData->querySelectorAll("span").size(), 2000);
+
+    EXPECT_EQ(body->getTagName(), "body");
+    EXPECT_EQ(paragraphs[0]->getContent(), "Text");
+    EXPECT_EQ(paragraphs[1]->getContent(), "Another text");
+    EXPECT_EQ(paragraphs[1]->getParent(), body);
+    EXPECT_EQ(parent, body);
+    EXPECT_EQ(pageData->querySelector("body"), body);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -7,8 +7,22 @@
 #include "domparser/DataParser.h"
 #include "domparser/AttributeParser.h"
 #include "domparser/AttributeValueParser.h"
+#include "domparser/Tokenizer.h"
+#include "domparser/StructuralIndex.h"
+#include "domparser/ISaxHandler.h"
+#include "domparser/PageSource.h"
+#include "domparser/Arena.h"
+#include "domparser/AtomTable.h"
+#include "domparser/Document.h"
+#include "domparser/PushParser.h"
+#include "domparser/DocumentIndex.h"
 
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <type_traits>
 
 TEST(MainParserTest, CheckTagChildren)
 {
@@ -45,6 +59,137 @@ TEST(MainParserTest, CheckTagParent)
     EXPECT_EQ(pageData[6].getParent()->getTagName(), "body");
 }
 
+TEST(MainParserTest, CssSelector)
+{
+    ProcessPage processPage("index.html", "html > body div ~ p:not(:last-of-type), i[size='2']");
+    processPage.process();
+    std::vector<Tag> pageData = processPage.getPageData();
+
+    ASSERT_EQ(pageData.size(), 2);
+    EXPECT_EQ(pageData[0].getContent(), "Text");
+    EXPECT_EQ(pageData[1].getTagName(), "i");
+}
+
+TEST(MainParserTest, EmptyPseudoClass)
+{
+    // Whitespace is text, comments are not
+    const std::string inputData = "<div><p> </p><p><!--c--></p><p></p><p><b></b></p><p>x</p></div>";
+    ProcessPage tokenizerPage("", "p:empty");
+    tokenizerPage.setSourceWebPage(inputData);
+    tokenizerPage.process();
+    ProcessPage regexPage("", "p:empty");
+    regexPage.setSourceWebPage(inputData);
+    regexPage.setParserEngine(ParserEngine::Regex);
+    regexPage.process();
+    ProcessPage pushPage("", "p:empty");
+    for (size_t i = 0; i < inputData.size(); ++i)
+    {
+        pushPage.feed(inputData.data() + i, 1);
+    }
+    pushPage.finish();
+
+    for (const auto& pageData : {tokenizerPage.getPageData(), regexPage.getPageData(), pushPage.getPageData()})
+    {
+        ASSERT_EQ(pageData.size(), 2);
+        EXPECT_EQ(pageData[0].getOuterHtmlView(), "<p><!--c--></p>");
+        EXPECT_EQ(pageData[1].getOuterHtmlView(), "<p></p>");
+    }
+}
+
+TEST(MainParserTest, SelectorSet)
+{
+    const std::vector<std::string> rules {"p", "[name]", "p", "body > *", "div ~ p, i", "*", "p:nth-child(2)"};
+    ProcessPage processPage("index.html");
+    auto results = processPage.process(SelectorSet(rules));
+
+    ASSERT_EQ(results.size(), rules.size());
+
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        ProcessPage single("index.html", rules[i]);
+        single.process();
+        auto expected = single.getPageData();
+
+        ASSERT_EQ(results[i].size(), expected.size()) << rules[i];
+        for (size_t j = 0; j < expected.size(); ++j)
+        {
+            EXPECT_EQ(results[i][j].getIndex(), expected[j].getIndex()) << rules[i];
+        }
+    }
+    EXPECT_EQ(results[0].size(), 2);
+    EXPECT_THROW(SelectorSet({"p", "&"}), std::logic_error);
+
+    // Removed tags are not matched, like in a single traversal
+    processPage.process();
+    processPage.getDocument().remove(7);
+    auto afterRemove = SelectorSet({"p", "body > *"}).select(processPage.getDocument());
+    EXPECT_EQ(afterRemove[0], std::vector<uint32_t>({8}));
+    EXPECT_EQ(afterRemove[1], std::vector<uint32_t>({6, 8, 9}));
+}
+
+TEST(MainParserTest, QueryLimits)
+{
+    ProcessPage processPage("index.html", "p");
+    QueryLimits limits;
+    limits.limit = 1;
+    processPage.process(limits);
+
+    // The page is not read past the end of the first paragraph
+    ASSERT_EQ(processPage.getPageData().size(), 1);
+    EXPECT_EQ(processPage.getPageData()[0].getIndex(), 7);
+    EXPECT_EQ(processPage.getPageData()[0].getContent(), "Text");
+    EXPECT_EQ(processPage.getDocument().getSize(), 8);
+
+    limits.offset = 1;
+    processPage.process(limits);
+    ASSERT_EQ(processPage.getPageData().size(), 1);
+    EXPECT_EQ(processPage.getPageData()[0].getIndex(), 8);
+
+    limits.limit = 0;
+    processPage.process(limits);
+    EXPECT_TRUE(processPage.getPageData().empty());
+
+    ProcessPage lastOfType("index.html", "p:last-of-type");
+    lastOfType.process(QueryLimits {0, 1, ""});
+    ASSERT_EQ(lastOfType.getPageData().size(), 1);
+    EXPECT_EQ(lastOfType.getPageData()[0].getIndex(), 8);
+
+    // Head-only extraction, the same with both engines
+    for (const auto engine : {ParserEngine::Tokenizer, ParserEngine::Regex})
+    {
+        ProcessPage head("index.html");
+        head.setParserEngine(engine);
+        head.process(QueryLimits {1, SIZE_MAX, "head"});
+        auto result = head.getPageData();
+
+        ASSERT_EQ(result.size(), 4);
+        EXPECT_EQ(result.front().getTagName(), "script");
+        EXPECT_EQ(result.back().getTagName(), "caption");
+    }
+
+    EXPECT_THROW(processPage.process(QueryLimits {0, 1, "&"}), std::logic_error);
+}
+
+TEST(MainParserTest, DocumentIndex)
+{
+    ProcessPage processPage("index.html");
+    processPage.setIndexing(true);
+    processPage.process();
+    const DocumentIndex* index = processPage.getDocument().getDocumentIndex();
+
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->getByTag(AtomTable::getGlobal().intern("p")), DocumentIndex::Nodes({7, 8}));
+    EXPECT_EQ(index->getByAttribute(AtomTable::getGlobal().intern("name")), DocumentIndex::Nodes({7, 8, 9}));
+    EXPECT_EQ(index->getByClass("nameCl"), DocumentIndex::Nodes({6}));
+    EXPECT_TRUE(index->getById("nameCl").empty());
+
+    std::unique_ptr<CheckRulesFactory> rule(CheckRulesFactory::createCheckRulesFactory(".nameCl"));
+    EXPECT_EQ(index->getCandidates(*rule), &index->getByClass("nameCl"));
+
+    processPage.setIndexing(false);
+    EXPECT_EQ(processPage.getDocument().getDocumentIndex(), nullptr);
+}
+
 TEST(MainParserTest, CheckTagAttributes)
 {
     ProcessPage processPage("index.html");
@@ -197,6 +342,936 @@ TEST(ContentParser, InvalidCase3)
     EXPECT_TRUE(result.empty());
 }
 
+TEST(Tokenizer, ValidCase)
+{
+    std::string inputData("<div class=\"name\" hidden size = '2'>Text<!-- note --><br/></div>");
+    Tokenizer tokenizer(inputData.data(), inputData.size());
+    Tokenizer::Token token;
+    std::vector<Tokenizer::TokenType> types;
+
+    ASSERT_TRUE(tokenizer.next(token));
+    EXPECT_EQ(token.type, Tokenizer::TokenType::StartTag);
+    EXPECT_EQ(inputData.substr(token.nameBegin, token.nameEnd - token.nameBegin), "div");
+    ASSERT_EQ(token.attributes.size(), 3);
+    EXPECT_EQ(inputData.substr(token.attributes[0].valueBegin, token.attributes[0].valueEnd - token.attributes[0].valueBegin), "name");
+    EXPECT_EQ(inputData.substr(token.attributes[1].nameBegin, token.attributes[1].nameEnd - token.attributes[1].nameBegin), "hidden");
+    EXPECT_EQ(token.attributes[1].valueBegin, token.attributes[1].valueEnd);
+    EXPECT_EQ(inputData.substr(token.attributes[2].valueBegin, token.attributes[2].valueEnd - token.attributes[2].valueBegin), "2");
+
+    while (tokenizer.next(token))
+    {
+        types.emplace_back(token.type);
+    }
+
+    ASSERT_EQ(types.size(), 4);
+    EXPECT_EQ(types[0], Tokenizer::TokenType::Text);
+    EXPECT_EQ(types[1], Tokenizer::TokenType::Comment);
+    EXPECT_EQ(types[2], Tokenizer::TokenType::StartTag);
+    EXPECT_EQ(types[3], Tokenizer::TokenType::EndTag);
+}
+
+TEST(Tokenizer, InvalidCase)
+{
+    std::string inputData("a < b <script>if (a<b) {}</script>");
+    Tokenizer tokenizer(inputData.data(), inputData.size());
+    Tokenizer::Token token;
+
+    ASSERT_TRUE(tokenizer.next(token));
+    EXPECT_EQ(token.type, Tokenizer::TokenType::Text);
+    EXPECT_EQ(inputData.substr(token.begin, token.end - token.begin), "a < b ");
+    ASSERT_TRUE(tokenizer.next(token));
+    EXPECT_EQ(token.type, Tokenizer::TokenType::StartTag);
+    ASSERT_TRUE(tokenizer.next(token));
+    EXPECT_EQ(token.type, Tokenizer::TokenType::Text);
+    EXPECT_EQ(inputData.substr(token.begin, token.end - token.begin), "if (a<b) {}");
+    ASSERT_TRUE(tokenizer.next(token));
+    EXPECT_EQ(token.type, Tokenizer::TokenType::EndTag);
+    EXPECT_FALSE(tokenizer.next(token));
+}
+
+TEST(Tokenizer, Attributes)
+{
+    std::string inputData(" hidden href=\"a?b=c\" title='it\"s' size=2 checked/");
+    std::vector<Tokenizer::Attribute> attributes;
+    Tokenizer::lexAttributes(inputData.data(), inputData.size(), attributes);
+
+    std::vector<std::pair<std::string, std::string>> result;
+    for (const auto& i : attributes)
+    {
+        result.emplace_back(inputData.substr(i.nameBegin, i.nameEnd - i.nameBegin),
+                            inputData.substr(i.valueBegin, i.valueEnd - i.valueBegin));
+    }
+
+    std::vector<std::pair<std::string, std::string>> expectResult {
+        {"hidden", ""}, {"href", "a?b=c"}, {"title", "it\"s"}, {"size", "2"}, {"checked", ""}
+    };
+    EXPECT_EQ(result, expectResult);
+
+    // Cut short in a value
+    inputData = " a b='x";
+    Tokenizer::lexAttributes(inputData.data(), inputData.size(), attributes);
+    ASSERT_EQ(attributes.size(), 2);
+    EXPECT_EQ(attributes[1].valueBegin, 6);
+    EXPECT_EQ(attributes[1].valueEnd, inputData.size());
+
+    ProcessPage regexPage("");
+    regexPage.setParserEngine(ParserEngine::Regex);
+    regexPage.setSourceWebPage("<input disabled value=\"a=b\"></input>");
+    regexPage.process();
+    ASSERT_EQ(regexPage.getPageData().size(), 1);
+    EXPECT_EQ(regexPage.getPageData()[0].getAttributeTag(), std::vector<std::string>({"disabled", "value"}));
+    EXPECT_EQ(regexPage.getPageData()[0].getAttributeValueTag(), std::vector<std::string>({"", "a=b"}));
+}
+
+TEST(Tokenizer, SkipAttributes)
+{
+    // The tags end where they do when the attributes are lexed, and the skipped text lexes the same
+    const std::string inputData("<a href=\"x>y\" title='a\"b'>t</a><br/><img src=a/b/><p / >x</p><x =y\"z>w</x>"
+                                "<i a = \"q>\" b=c d/>j</i><script type='a>b'>if (a<b) {}</script><e f='g");
+
+    for (size_t chunkSize : {size_t(1), inputData.size()})
+    {
+        Tokenizer lexed(nullptr, 0);
+        Tokenizer skipped(nullptr, 0);
+        skipped.setSkipAttributes(true);
+        std::vector<Tokenizer::Token> lexedTokens;
+        std::vector<Tokenizer::Token> skippedTokens;
+        Tokenizer::Token token;
+        std::vector<Tokenizer::Attribute> attributes;
+
+        // Push mode, so that the skipping states are resumed between chunks
+        for (size_t size = chunkSize; ; size = std::min(size + chunkSize, inputData.size()))
+        {
+            const bool final = size == inputData.size();
+            lexed.setInput(inputData.data(), size, final);
+            skipped.setInput(inputData.data(), size, final);
+            while (lexed.next(token))
+            {
+                lexedTokens.push_back(token);
+            }
+            while (skipped.next(token))
+            {
+                skippedTokens.push_back(token);
+            }
+            if (final)
+            {
+                break;
+            }
+        }
+
+        ASSERT_EQ(lexedTokens.size(), skippedTokens.size());
+        for (size_t i = 0; i < lexedTokens.size(); ++i)
+        {
+            const auto& expected = lexedTokens[i];
+            const auto& result = skippedTokens[i];
+            EXPECT_EQ(result.type, expected.type) << i;
+            EXPECT_EQ(result.begin, expected.begin) << i;
+            EXPECT_EQ(result.end, expected.end) << i;
+            EXPECT_EQ(result.nameEnd, expected.nameEnd) << i;
+            EXPECT_EQ(result.selfClosing, expected.selfClosing) << i;
+            EXPECT_TRUE(result.attributes.empty()) << i;
+
+            if (result.type == Tokenizer::TokenType::StartTag)
+            {
+                Tokenizer::lexAttributes(inputData.data() + result.nameEnd, result.end - 1 - result.nameEnd, attributes);
+                ASSERT_EQ(attributes.size(), expected.attributes.size()) << i;
+                for (size_t j = 0; j < attributes.size(); ++j)
+                {
+                    EXPECT_EQ(attributes[j].nameBegin + result.nameEnd, expected.attributes[j].nameBegin) << i;
+                    EXPECT_EQ(attributes[j].valueEnd + result.nameEnd, expected.attributes[j].valueEnd) << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(MainParserTest, CompareEngines)
+{
+    ProcessPage regexPage("index.html");
+    regexPage.setParserEngine(ParserEngine::Regex);
+    regexPage.process();
+    ProcessPage tokenizerPage("index.html");
+    tokenizerPage.process();
+
+    std::vector<Tag> regexData = regexPage.getPageData();
+    std::vector<Tag> tokenizerData = tokenizerPage.getPageData();
+
+    ASSERT_EQ(regexData.size(), tokenizerData.size());
+    for (size_t i = 0; i < regexData.size(); ++i)
+    {
+        EXPECT_EQ(regexData[i].getTagName(), tokenizerData[i].getTagName());
+        EXPECT_EQ(regexData[i].getContent(), tokenizerData[i].getContent());
+        EXPECT_EQ(regexData[i].getAttributeTag(), tokenizerData[i].getAttributeTag());
+        EXPECT_EQ(regexData[i].getAttributeValueTag(), tokenizerData[i].getAttributeValueTag());
+    }
+}
+
+TEST(MainParserTest, ViewsIntoSource)
+{
+    ProcessPage processPage("index.html");
+    processPage.process();
+    auto source = processPage.getSource();
+    std::vector<Tag> tags = processPage.getPageData();
+
+    auto inSource = [&source](const StringSpan& span)
+    {
+        return span.data() >= source->getData() && span.data() + span.size() <= source->getData() + source->getSize();
+    };
+
+    ASSERT_EQ(tags.size(), 10);
+    for (const auto& i : tags)
+    {
+        EXPECT_TRUE(inSource(i.getTagNameView()));
+        EXPECT_TRUE(inSource(i.getContentView()));
+        for (size_t j = 0; j < i.getAttributeCount(); ++j)
+        {
+            EXPECT_TRUE(inSource(i.getAttributeName(j)));
+            EXPECT_TRUE(inSource(i.getAttributeValue(j)));
+        }
+    }
+
+    Tag& italic = tags[9];
+    ASSERT_EQ(italic.getAttributeCount(), 3);
+    italic.replaceAttribute(0, "color", "red");
+    EXPECT_FALSE(inSource(italic.getAttributeName(0)));
+    EXPECT_TRUE(inSource(italic.getAttributeName(1)));
+    EXPECT_EQ(italic.getAttributeName(0), "color");
+
+    italic.setContent("text");
+    EXPECT_FALSE(inSource(italic.getContentView()));
+    EXPECT_EQ(italic.getContentView(), "text");
+    EXPECT_TRUE(inSource(tags[8].getContentView()));
+}
+
+TEST(MainParserTest, OuterHtmlAndText)
+{
+    for (const auto engine : {ParserEngine::Tokenizer, ParserEngine::Regex})
+    {
+        ProcessPage processPage("");
+        processPage.setParserEngine(engine);
+        processPage.setSourceWebPage("<div id=\"a\">Hello <b>bold <i>and</i></b> world<p>!</p></div>");
+        processPage.process();
+        auto source = processPage.getSource();
+        std::vector<Tag> tags = processPage.getPageData();
+
+        ASSERT_EQ(tags.size(), 4);
+        EXPECT_EQ(tags[0].getOuterHtmlView().data(), source->getData());
+        EXPECT_EQ(tags[0].getOuterHtmlView().size(), source->getSize());
+        EXPECT_EQ(tags[1].getOuterHtmlView(), "<b>bold <i>and</i></b>");
+        EXPECT_EQ(tags[2].getOuterHtmlView(), "<i>and</i>");
+        // The content of the parent is not copied for its children
+        EXPECT_EQ(tags[1].getContentView().data(), tags[0].getContentView().data() + 9);
+
+        EXPECT_EQ(tags[0].getText(), "Hello  world");
+        EXPECT_EQ(tags[1].getText(), "bold ");
+        EXPECT_EQ(tags[2].getText(), "and");
+        EXPECT_EQ(tags[3].getText(), "!");
+
+        tags[1].setContent("plain");
+        EXPECT_TRUE(tags[1].getOuterHtmlView().empty());
+        EXPECT_EQ(tags[1].getText(), "plain");
+    }
+
+    ProcessPage processPage("index.html", "p");
+    processPage.process();
+    ASSERT_EQ(processPage.getPageData().size(), 2);
+    EXPECT_EQ(processPage.getPageData()[0].getOuterHtmlView(), "<p name=\"nameP\">Text</p>");
+}
+
+TEST(MainParserTest, LazyAttributes)
+{
+    for (const auto engine : {ParserEngine::Tokenizer, ParserEngine::Regex})
+    {
+        ProcessPage eagerPage("index.html");
+        eagerPage.setParserEngine(engine);
+        eagerPage.process();
+        ProcessPage lazyPage("index.html");
+        lazyPage.setParserEngine(engine);
+        lazyPage.setLazyAttributes(true);
+        lazyPage.process();
+
+        std::vector<Tag> eagerData = eagerPage.getPageData();
+        std::vector<Tag> lazyData = lazyPage.getPageData();
+        ASSERT_EQ(lazyData.size(), eagerData.size());
+        for (size_t i = 0; i < lazyData.size(); ++i)
+        {
+            EXPECT_EQ(lazyData[i].getAttributeTag(), eagerData[i].getAttributeTag());
+            EXPECT_EQ(lazyData[i].getAttributeValueTag(), eagerData[i].getAttributeValueTag());
+        }
+
+        // A mutation lexes the attributes first
+        Tag& italic = lazyPage.getDocument().getNode(9);
+        italic.eraseAttribute(0);
+        EXPECT_EQ(italic.getAttributeTag(), std::vector<std::string>({"size", "with"}));
+    }
+
+    // Names of attributes that are never read are not even interned
+    ProcessPage processPage("", "p");
+    processPage.setLazyAttributes(true);
+    processPage.setSourceWebPage("<div lazyunreadname=\"1\"><p lazyreadname='2'>Text</p></div>");
+    processPage.process();
+    ASSERT_EQ(processPage.getPageData().size(), 1);
+    EXPECT_EQ(AtomTable::getGlobal().find("lazyunreadname"), AtomTable::None);
+    EXPECT_EQ(AtomTable::getGlobal().find("lazyreadname"), AtomTable::None);
+
+    ProcessPage attributePage("", "p[lazyreadname='2']");
+    attributePage.setLazyAttributes(true);
+    attributePage.setSourceWebPage("<div lazyunreadname=\"1\"><p lazyreadname='2'>Text</p></div>");
+    attributePage.process();
+    ASSERT_EQ(attributePage.getPageData().size(), 1);
+    EXPECT_EQ(AtomTable::getGlobal().find("lazyunreadname"), AtomTable::None);
+}
+
+TEST(MainParserTest, SelectiveBuild)
+{
+    const std::string inputData = "<html><body><div class=\"a\"><p>1</p><table><tr><td>2</td></tr>"
+                                  "<tr><td class=\"b\">3</td></tr></table></div><table><tr><td>4</td></tr></table>"
+                                  "<ul><li>5</li><li><ul><li>6</li></ul></li></ul></body></html>";
+    const char* rules[] = {"table > tr", "table td.b", "ul li", "div.a p", "td", "tr + tr > td", "li + li", "*"};
+
+    for (const auto engine : {ParserEngine::Tokenizer, ParserEngine::Regex})
+    {
+        for (const auto rule : rules)
+        {
+            ProcessPage fullPage("", rule);
+            fullPage.setParserEngine(engine);
+            fullPage.setSourceWebPage(inputData);
+            fullPage.process();
+            ProcessPage selectivePage("", rule);
+            selectivePage.setParserEngine(engine);
+            selectivePage.setSelectiveBuild(true);
+            selectivePage.setSourceWebPage(inputData);
+            selectivePage.process();
+
+            std::vector<Tag> fullData = fullPage.getPageData();
+            std::vector<Tag> selectiveData = selectivePage.getPageData();
+            ASSERT_EQ(selectiveData.size(), fullData.size()) << rule;
+            for (size_t i = 0; i < selectiveData.size(); ++i)
+            {
+                EXPECT_EQ(selectiveData[i].getTagName(), fullData[i].getTagName()) << rule;
+                EXPECT_EQ(selectiveData[i].getContent(), fullData[i].getContent()) << rule;
+                EXPECT_EQ(selectiveData[i].getAttributeTag(), fullData[i].getAttributeTag()) << rule;
+            }
+            EXPECT_LE(selectivePage.getDocument().getSize(), fullPage.getDocument().getSize()) << rule;
+        }
+
+        // Only the two tables are built, each without a parent
+        ProcessPage processPage("", "table > tr");
+        processPage.setParserEngine(engine);
+        processPage.setSelectiveBuild(true);
+        processPage.setSourceWebPage(inputData);
+        processPage.process();
+        Document& document = processPage.getDocument();
+        ASSERT_EQ(document.getSize(), 8);
+        EXPECT_EQ(document.getNode(0).getTagName(), "table");
+        EXPECT_EQ(document.getNode(0).getParent(), nullptr);
+        EXPECT_EQ(document.getNode(5).getTagName(), "table");
+        EXPECT_EQ(document.getNode(5).getParent(), nullptr);
+        EXPECT_EQ(processPage.getPageData().size(), 3);
+    }
+}
+
+TEST(MainParserTest, DeepNesting)
+{
+    std::string inputData;
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        inputData += "<div>";
+    }
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        inputData += "</div>";
+    }
+    ProcessPage processPage("");
+    processPage.setSourceWebPage(inputData);
+    processPage.process();
+    std::vector<Tag> pageData = processPage.getPageData();
+
+    ASSERT_EQ(pageData.size(), 5000);
+    EXPECT_EQ(pageData[4999].getParent()->getTagName(), "div");
+    EXPECT_TRUE(pageData[4999].getContent().empty());
+
+    // The regex engine stops at the first end tag with the name, so the levels are named apart.
+    // It scans for the end tags, this depth used to overflow the stack.
+    inputData.clear();
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        inputData += "<d" + std::to_string(i) + ">";
+    }
+    for (size_t i = 10000; i > 0; --i)
+    {
+        inputData += "</d" + std::to_string(i - 1) + ">";
+    }
+    processPage.setParserEngine(ParserEngine::Regex);
+    processPage.setSourceWebPage(inputData);
+    processPage.process();
+    pageData = processPage.getPageData();
+
+    ASSERT_EQ(pageData.size(), 10000);
+    EXPECT_EQ(pageData[9999].getTagName(), "d9999");
+    EXPECT_EQ(pageData[9999].getParent()->getTagName(), "d9998");
+    EXPECT_EQ(pageData[0].getSubtreeEnd(), 10000);
+}
+
+TEST(StructuralIndex, ValidCase)
+{
+    std::string inputData("<div class=\"a/b\" id='c'>x &amp; y</div>");
+    StructuralIndex index;
+    std::vector<uint32_t> expectResult;
+
+    for (size_t i = 0; i < inputData.size(); ++i)
+    {
+        if (StructuralIndex::isStructural(inputData[i]))
+        {
+            expectResult.emplace_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    EXPECT_TRUE(index.build(inputData.data(), inputData.size(), StructuralIndex::Implementation::Scalar));
+    EXPECT_EQ(index.getPositions(), expectResult);
+    EXPECT_EQ(index.find('=', 0), 10);
+    EXPECT_EQ(index.find('<', 1), 33);
+}
+
+TEST(StructuralIndex, AllImplementations)
+{
+    std::string inputData;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        inputData += "<p a=\"" + std::to_string(i) + "\" b='x'>t/" + std::to_string(i % 7) + "&lt;</p>";
+    }
+    StructuralIndex scalar;
+    scalar.build(inputData.data(), inputData.size(), StructuralIndex::Implementation::Scalar);
+
+    for (auto implementation : {StructuralIndex::Implementation::SSE2, StructuralIndex::Implementation::AVX2})
+    {
+        StructuralIndex index;
+        if (StructuralIndex::isSupported(implementation))
+        {
+            EXPECT_TRUE(index.build(inputData.data(), inputData.size(), implementation));
+            EXPECT_EQ(index.getPositions(), scalar.getPositions());
+        }
+        else
+        {
+            EXPECT_FALSE(index.build(inputData.data(), inputData.size(), implementation));
+        }
+    }
+}
+
+class CountSaxHandler : public ISaxHandler
+{
+public:
+    virtual void startElement(const std::string& name, const std::vector<std::pair<std::string, std::string>>& attributes)
+    {
+        names.emplace_back(name);
+        numberOfAttributes += attributes.size();
+    }
+
+    virtual void endElement(const std::string&)
+    {
+        ++numberOfEndElements;
+    }
+
+    virtual void text(const std::string& value)
+    {
+        texts.emplace_back(value);
+    }
+
+    std::vector<std::string> names {};
+    std::vector<std::string> texts {};
+    size_t numberOfAttributes = 0;
+    size_t numberOfEndElements = 0;
+};
+
+TEST(SaxParserTest, AllTags)
+{
+    ProcessPage processPage("index.html");
+    CountSaxHandler handler;
+    processPage.process(handler);
+
+    EXPECT_EQ(handler.names.size(), 10);
+    EXPECT_EQ(handler.numberOfEndElements, 10);
+    EXPECT_EQ(handler.numberOfAttributes, 8);
+    EXPECT_EQ(handler.names[0], "html");
+    EXPECT_EQ(handler.names[9], "i");
+    EXPECT_TRUE(processPage.getPageData().empty());
+}
+
+TEST(SaxParserTest, FilterByRule)
+{
+    ProcessPage processPage("index.html", "[name]");
+    CountSaxHandler handler;
+    processPage.process(handler);
+
+    ASSERT_EQ(handler.names.size(), 3);
+    EXPECT_EQ(handler.names[0], "p");
+    EXPECT_EQ(handler.names[2], "i");
+    EXPECT_EQ(handler.numberOfEndElements, 3);
+    ASSERT_EQ(handler.texts.size(), 3);
+    EXPECT_EQ(handler.texts[0], "Text");
+    EXPECT_EQ(handler.texts[2], "Content");
+}
+
+TEST(SaxParserTest, StrayEndTags)
+{
+    // Each stray end tag used to walk every open element, which took seconds here
+    std::string inputData;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        inputData += "<div>";
+    }
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        inputData += "</x>";
+    }
+    inputData += "</div>";
+    ProcessPage processPage("", "div");
+    processPage.setSourceWebPage(inputData);
+    CountSaxHandler handler;
+
+    const auto begin = std::chrono::steady_clock::now();
+    processPage.process();
+    processPage.process(handler);
+    const auto end = std::chrono::steady_clock::now();
+
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count(), 2000);
+    EXPECT_EQ(processPage.getPageData().size(), 20000);
+    EXPECT_EQ(handler.names.size(), 20000);
+    EXPECT_EQ(handler.numberOfEndElements, 20000);
+}
+
+TEST(SaxParserTest, SiblingRules)
+{
+    const std::string inputData = "<ul><li>a</li><li>b</li><li>c</li></ul>";
+    CountSaxHandler handler;
+
+    for (const std::string rule : {"li:first-child", "li:last-child", "li + li", "li ~ li", "li:nth-child(2)", "li:empty"})
+    {
+        ProcessPage processPage("", rule);
+        processPage.setSourceWebPage(inputData);
+        EXPECT_THROW(processPage.process(handler), std::logic_error) << rule;
+        EXPECT_THROW(processPage.beginFeed(&handler), std::logic_error) << rule;
+    }
+    EXPECT_TRUE(handler.names.empty());
+
+    // Rules that only read ancestors still stream
+    ProcessPage processPage("", "ul > li");
+    processPage.setSourceWebPage(inputData);
+    processPage.process(handler);
+    EXPECT_EQ(handler.names.size(), 3);
+}
+
+TEST(SaxParserTest, IncorrectRule)
+{
+    ProcessPage processPage("index.html", "[*=$#");
+    CountSaxHandler handler;
+    EXPECT_THROW(processPage.process(handler), std::logic_error);
+}
+
+TEST(PushParserTest, Chunks)
+{
+    std::ifstream inputFile("index.html");
+    std::string inputData((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+    ProcessPage processPage("index.html");
+    processPage.process();
+    std::vector<Tag> expectResult = processPage.getPageData();
+
+    for (size_t chunkSize : {1, 7, 64, 65536})
+    {
+        ProcessPage pushPage("");
+        for (size_t i = 0; i < inputData.size(); i += chunkSize)
+        {
+            pushPage.feed(inputData.data() + i, std::min(chunkSize, inputData.size() - i));
+        }
+        pushPage.finish();
+        std::vector<Tag> result = pushPage.getPageData();
+
+        ASSERT_EQ(result.size(), expectResult.size());
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            EXPECT_EQ(result[i].getTagName(), expectResult[i].getTagName());
+            EXPECT_EQ(result[i].getContent(), expectResult[i].getContent());
+            EXPECT_EQ(result[i].getAttributeTag(), expectResult[i].getAttributeTag());
+            EXPECT_EQ(result[i].getAttributeValueTag(), expectResult[i].getAttributeValueTag());
+            EXPECT_EQ(result[i].getOuterHtmlView(), expectResult[i].getOuterHtmlView());
+            EXPECT_EQ(result[i].getText(), expectResult[i].getText());
+        }
+    }
+}
+
+TEST(PushParserTest, NestedContent)
+{
+    const size_t depth = 500;
+    std::string inputData;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        inputData += "<div>";
+    }
+    inputData += "text";
+    for (size_t i = 0; i < depth; ++i)
+    {
+        inputData += "</div>";
+    }
+
+    ProcessPage pushPage("");
+    for (size_t i = 0; i < inputData.size(); i += 16)
+    {
+        pushPage.feed(inputData.data() + i, std::min<size_t>(16, inputData.size() - i));
+    }
+    pushPage.finish();
+    Document& document = pushPage.getDocument();
+
+    // The elements share one copy of the markup instead of each keeping its inner markup
+    ASSERT_EQ(document.getSize(), depth);
+    EXPECT_EQ(document.getNode(0).getOuterHtmlView(), inputData);
+    EXPECT_EQ(document.getNode(depth - 1).getContent(), "text");
+    EXPECT_LT(document.getArena().getUsed(), inputData.size() * 4);
+}
+
+TEST(PushParserTest, BoundedBuffer)
+{
+    std::string inputData = "<html><body>";
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        inputData += "<p class=\"item\">Item " + std::to_string(i) + "</p>\n";
+    }
+    inputData += "</body></html>";
+
+    // The open elements are copied out of the buffer, which only keeps the token being read
+    Arena arena;
+    Document document(arena);
+    PushParser parser(document);
+    size_t bufferSize = 0;
+    for (size_t i = 0; i < inputData.size(); i += 256)
+    {
+        parser.feed(inputData.data() + i, std::min<size_t>(256, inputData.size() - i));
+        bufferSize = std::max(bufferSize, parser.getBufferSize());
+    }
+    parser.finish();
+
+    EXPECT_LT(bufferSize, 1024);
+    ASSERT_EQ(document.getSize(), 20002);
+    EXPECT_TRUE(document.getNode(0).getOuterHtmlView() == inputData);
+    EXPECT_TRUE(document.getNode(1).getContentView() == inputData.substr(12, inputData.size() - 27));
+    EXPECT_EQ(document.getNode(20001).getOuterHtmlView(), "<p class=\"item\">Item 19999</p>");
+    EXPECT_EQ(document.getNode(20001).getContent(), "Item 19999");
+}
+
+TEST(PushParserTest, SaxChunks)
+{
+    std::string inputData("<a href='x'>one<!-- c --><script>if (a</b) {}</script><b>two</b></a>");
+    ProcessPage processPage("");
+    CountSaxHandler handler;
+    processPage.beginFeed(&handler);
+
+    for (size_t i = 0; i < inputData.size(); ++i)
+    {
+        processPage.feed(inputData.data() + i, 1);
+    }
+    processPage.finish();
+
+    ASSERT_EQ(handler.names.size(), 3);
+    EXPECT_EQ(handler.names[1], "script");
+    EXPECT_EQ(handler.numberOfAttributes, 1);
+    EXPECT_EQ(handler.numberOfEndElements, 3);
+    ASSERT_EQ(handler.texts.size(), 3);
+    EXPECT_EQ(handler.texts[0], "one");
+    EXPECT_EQ(handler.texts[1], "if (a</b) {}");
+    EXPECT_EQ(handler.texts[2], "two");
+}
+
+TEST(PushParserTest, SplitDeclarations)
+{
+    std::string inputData("<div><!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0//EN\"><?xml version=\"1.0\"?>"
+                          "<a>one</a><!DOCTYPE x><b>two</b></div>");
+
+    for (size_t chunkSize : {1, 3, 5, 17})
+    {
+        ProcessPage processPage("");
+        CountSaxHandler handler;
+        processPage.beginFeed(&handler);
+
+        for (size_t i = 0; i < inputData.size(); i += chunkSize)
+        {
+            processPage.feed(inputData.data() + i, std::min(chunkSize, inputData.size() - i));
+        }
+        processPage.finish();
+
+        ASSERT_EQ(handler.names.size(), 3) << chunkSize;
+        EXPECT_EQ(handler.names[1], "a");
+        EXPECT_EQ(handler.names[2], "b");
+        ASSERT_EQ(handler.texts.size(), 2) << chunkSize;
+        EXPECT_EQ(handler.texts[0], "one");
+        EXPECT_EQ(handler.texts[1], "two");
+    }
+}
+
+TEST(ArenaTest, ValidCase)
+{
+    Arena arena(256);
+    auto first = static_cast<char*>(arena.allocate(3, 1));
+    auto second = arena.allocate(sizeof(double), alignof(double));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % alignof(double), 0);
+    EXPECT_EQ(arena.copy("text"), "text");
+
+    arena.allocate(1000);
+    const size_t capacity = arena.getCapacity();
+    EXPECT_GE(capacity, 1256);
+
+    arena.reset();
+    EXPECT_EQ(arena.getUsed(), 0);
+    EXPECT_EQ(arena.allocate(3, 1), first);
+    arena.allocate(1000);
+    EXPECT_EQ(arena.getCapacity(), capacity);
+}
+
+TEST(ArenaTest, TagsInArena)
+{
+    Arena arena;
+    Tag* tag = arena.create<Tag>(&arena);
+    tag->setTagName("div");
+    tag->setAttributeTag("class");
+    tag->setAttributeValueTag("main");
+    tag->setContent("text");
+
+    EXPECT_EQ(tag->getTagName(), "div");
+    EXPECT_EQ(tag->getAttributeName(0), "class");
+    EXPECT_EQ(tag->getAttributeValue(0), "main");
+    EXPECT_EQ(tag->getContent(), "text");
+    EXPECT_GT(arena.getUsed(), sizeof(Tag));
+
+    Tag copy(*tag);
+    EXPECT_TRUE(copy == *tag);
+    tag->~Tag();
+}
+
+TEST(ArenaTest, MoveTags)
+{
+    static_assert(std::is_nothrow_move_constructible<Tag>::value, "Tags are moved when a vector grows");
+
+    Arena arena;
+    Tag tag(&arena);
+    tag.setTagName("div");
+    tag.setAttributeView("class", "main");
+    tag.getAttributeValueTag()[0] = "side";
+    tag.getContent() = "text";
+
+    Tag copy(tag);
+    copy.getAttributeValueTag()[0] = "top";
+    EXPECT_EQ(tag.getAttributeValue(0), "side");
+
+    Tag moved(std::move(copy));
+    EXPECT_EQ(moved.getTagName(), "div");
+    EXPECT_EQ(moved.getAttributeValue(0), "top");
+    EXPECT_EQ(moved.getContent(), "text");
+
+    copy = moved;
+    EXPECT_EQ(copy.getAttributeName(0), "class");
+    EXPECT_EQ(copy.getContent(), "text");
+}
+
+TEST(ArenaTest, CopiesOutliveTheDocument)
+{
+    ProcessPage processPage("index.html");
+    processPage.process();
+    std::vector<Tag> pageData = processPage.getPageData();
+    Tag copy(pageData[9]);
+
+    // The arena is reused by the next parse, the copies keep their own attributes
+    const std::string chunk("<div>" + std::string(4096, 'x') + "</div>");
+    processPage.beginFeed();
+    processPage.feed(chunk.data(), chunk.size());
+    processPage.finish();
+    EXPECT_EQ(copy.getAttributeTag(), std::vector<std::string>({"name", "size", "with"}));
+    EXPECT_EQ(pageData[9].getAttributeValueTag()[1], "2");
+}
+
+TEST(DocumentTest, CopiesOutliveTheParser)
+{
+    std::vector<Tag> pageData;
+    {
+        ProcessPage processPage("index.html");
+        processPage.setLazyAttributes(true);
+        processPage.process();
+        pageData = processPage.getPageData();
+    }
+
+    // The copies keep the mapped page and the document alive
+    ASSERT_EQ(pageData.size(), 10);
+    EXPECT_EQ(pageData[9].getAttributeValueTag(), std::vector<std::string>({"nameI", "2", "6"}));
+    EXPECT_EQ(pageData[7].getContent(), "Text");
+    ASSERT_NE(pageData[7].getParent(), nullptr);
+    EXPECT_EQ(pageData[7].getParent()->getTagName(), "body");
+
+    // Parsing again leaves the copies of the last page as they are, the document is reused once they are gone
+    ProcessPage processPage("index.html", "p");
+    processPage.process();
+    std::vector<Tag> first = processPage.getPageData();
+    const Document* document = &processPage.getDocument();
+    processPage.setSourceWebPage("<p>Other</p>");
+    processPage.process();
+    EXPECT_NE(&processPage.getDocument(), document);
+    EXPECT_EQ(first[0].getContent(), "Text");
+    EXPECT_EQ(first[0].getParent()->getChildren().size(), 4);
+
+    document = &processPage.getDocument();
+    processPage.process();
+    EXPECT_EQ(&processPage.getDocument(), document);
+    ASSERT_EQ(processPage.getPageData().size(), 1);
+    EXPECT_EQ(processPage.getPageData()[0].getContent(), "Other");
+}
+
+TEST(DocumentTest, Links)
+{
+    ProcessPage processPage("index.html");
+    processPage.process();
+    std::vector<Tag> pageData = processPage.getPageData();
+
+    ASSERT_EQ(pageData.size(), 10);
+    EXPECT_EQ(pageData[0].getSubtreeEnd(), 10);
+    EXPECT_EQ(pageData[0].getParentIndex(), Document::npos);
+    EXPECT_EQ(pageData[3].getFirstChildIndex(), 4);
+    EXPECT_EQ(pageData[3].getSubtreeEnd(), 5);
+    EXPECT_EQ(pageData[5].getFirstChildIndex(), 6);
+    EXPECT_EQ(pageData[6].getNextSiblingIndex(), 7);
+    EXPECT_EQ(pageData[9].getNextSiblingIndex(), Document::npos);
+    EXPECT_EQ(pageData[9].getParentIndex(), 5);
+}
+
+TEST(DocumentTest, Reallocation)
+{
+    Arena arena;
+    Document document(arena);
+    document.append();
+
+    // Odd tags are children of the root, every even one is a child of the tag before it
+    for (uint32_t i = 1; i <= 1000; ++i)
+    {
+        document.append(i % 2 == 1 ? 0 : i - 1);
+    }
+    document.close(0);
+
+    EXPECT_EQ(document.getNode(0).getSubtreeEnd(), 1001);
+    EXPECT_EQ(document.getNode(0).getChildren().size(), 500);
+    EXPECT_EQ(document.getNode(1000).getParent(), &document.getNode(999));
+    EXPECT_EQ(document.getNode(999).getParent(), &document.getNode(0));
+    document.clear();
+    EXPECT_EQ(document.getSize(), 0);
+}
+
+TEST(AtomTableTest, ValidCase)
+{
+    AtomTable table;
+    auto div = table.intern("div");
+    EXPECT_NE(div, AtomTable::None);
+    EXPECT_EQ(table.intern(std::string("div")), div);
+    EXPECT_EQ(table.find("div"), div);
+    EXPECT_EQ(table.find("unknown"), AtomTable::None);
+    EXPECT_EQ(table.intern(""), AtomTable::None);
+    EXPECT_EQ(table.getName(div), "div");
+
+    std::vector<AtomTable::Atom> atoms;
+    for (int i = 0; i < 1000; ++i)
+    {
+        atoms.emplace_back(table.intern("name" + std::to_string(i)));
+    }
+    EXPECT_EQ(table.getSize(), KnownNames::getCount() + 1000);
+    EXPECT_EQ(table.find("name500"), atoms[500]);
+    EXPECT_EQ(table.getName(atoms[999]), "name999");
+    EXPECT_EQ(table.find("div"), div);
+}
+
+TEST(KnownNamesTest, ValidCase)
+{
+    EXPECT_EQ(KnownNames::find("div"), KnownName::Div);
+    EXPECT_EQ(KnownNames::find("class"), KnownName::Class);
+    EXPECT_EQ(KnownNames::find("http-equiv"), KnownName::HttpEquiv);
+    EXPECT_EQ(KnownNames::find("DIV"), KnownName::None);
+    EXPECT_EQ(KnownNames::find("divs"), KnownName::None);
+    EXPECT_EQ(KnownNames::find(""), KnownName::None);
+
+    for (size_t i = 1; i <= KnownNames::getCount(); ++i)
+    {
+        const auto name = static_cast<KnownName>(i);
+        EXPECT_EQ(KnownNames::find(KnownNames::getName(name)), name);
+        EXPECT_EQ(AtomTable::getGlobal().intern(KnownNames::getName(name)), i);
+    }
+
+    Tag tag("div");
+    EXPECT_TRUE(tag.hasTagName(KnownName::Div));
+    EXPECT_FALSE(tag.hasTagName(KnownName::Span));
+}
+
+TEST(AtomTableTest, TagAtoms)
+{
+    ProcessPage processPage("index.html");
+    processPage.process();
+    std::vector<Tag> pageData = processPage.getPageData();
+
+    ASSERT_EQ(pageData.size(), 10);
+    EXPECT_EQ(pageData[7].getTagAtom(), pageData[8].getTagAtom());
+    EXPECT_EQ(pageData[7].getTagAtom(), AtomTable::getGlobal().find("p"));
+    EXPECT_EQ(pageData[7].findAttribute(AtomTable::getGlobal().find("name")), 0);
+    EXPECT_EQ(pageData[7].findAttribute(AtomTable::getGlobal().intern("size")), std::string::npos);
+
+    pageData[7].getAttributeTag()[0] = "size";
+    EXPECT_EQ(pageData[7].findAttribute(AtomTable::getGlobal().find("size")), 0);
+}
+
+TEST(AtomTableTest, DocumentNames)
+{
+    // Names of the page are looked up, only rules add names to the table
+    const size_t size = AtomTable::getGlobal().getSize();
+    ProcessPage processPage("");
+    processPage.setIndexing(true);
+    processPage.setSourceWebPage("<section><docnamea docattra='1'>1</docnamea><docnameb>2</docnameb>"
+                                 "<docnamea>3</docnamea></section>");
+    processPage.process();
+    Document& document = processPage.getDocument();
+
+    ASSERT_EQ(document.getSize(), 4);
+    EXPECT_EQ(AtomTable::getGlobal().getSize(), size);
+    EXPECT_EQ(document.getNode(1).getTagAtom(), AtomTable::None);
+
+    // Unknown names of the same type are told apart by their text
+    std::unique_ptr<CheckRulesFactory> ofType(CheckRulesFactory::createCheckRulesFactory(":nth-of-type(2)"));
+    EXPECT_FALSE(ofType->checkRules(&document.getNode(2)));
+    EXPECT_TRUE(ofType->checkRules(&document.getNode(3)));
+
+    // A rule compiled after parsing still matches the tags and their index entries
+    std::unique_ptr<CheckRulesFactory> byTag(CheckRulesFactory::createCheckRulesFactory("docnamea"));
+    std::unique_ptr<CheckRulesFactory> byAttribute(CheckRulesFactory::createCheckRulesFactory("[docattra]"));
+    EXPECT_NE(document.getNode(1).getTagAtom(), AtomTable::None);
+    EXPECT_TRUE(byTag->checkRules(&document.getNode(3)));
+    EXPECT_FALSE(byTag->checkRules(&document.getNode(2)));
+    EXPECT_TRUE(byAttribute->checkRules(&document.getNode(1)));
+    EXPECT_EQ(*document.getDocumentIndex()->getCandidates(*byTag), DocumentIndex::Nodes({1, 3}));
+    EXPECT_EQ(*document.getDocumentIndex()->getCandidates(*byAttribute), DocumentIndex::Nodes({1}));
+    EXPECT_FALSE(ofType->checkRules(&document.getNode(2)));
+}
+
+TEST(PageSourceTest, MappedFile)
+{
+    std::ifstream inputFile("index.html");
+    std::string inputData((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+    PageSource source;
+
+    EXPECT_TRUE(source.open("index.html"));
+    EXPECT_TRUE(source.isMapped());
+    EXPECT_EQ(std::string(source.getData(), source.getSize()), inputData);
+}
+
+TEST(PageSourceTest, InvalidCase)
+{
+    PageSource source;
+    PageSource stringSource("<p>Text</p>");
+
+    EXPECT_FALSE(source.open("index1.html"));
+    EXPECT_TRUE(source.empty());
+    EXPECT_FALSE(stringSource.isMapped());
+    EXPECT_EQ(stringSource.getSize(), 11);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
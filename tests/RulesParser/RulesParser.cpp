@@ -1,9 +1,48 @@
 #include "gtest/gtest.h"
 
 #include "domparser/CheckRulesFactory.h"
+#include "domparser/Document.h"
+#include "domparser/SelectorCache.h"
+#include "domparser/SelectorDsl.h"
 #include "domparser/Tag.h"
+#include "domparser/TreeBuilder.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Counts the heap allocations of the whole test binary, the library included
+    size_t allocationCount = 0;
+}
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
 
 TEST(SelectAllRule, ValidCase)
 {
@@ -102,10 +141,15 @@ TEST(SelectAllWithAttribute, AnotherAttribute)
     EXPECT_FALSE(ptr->checkRules(tag.get()));
 }
 
-TEST(SelectAllWithAttribute, BadRule)
+TEST(SelectAllWithAttribute, TypeSelector)
 {
     std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("id"));
-    EXPECT_EQ(ptr.get(), nullptr);
+    std::unique_ptr<Tag> tag(new Tag);
+    tag->setTagName("div");
+    tag->setAttributeTag("id");
+    tag->setAttributeValueTag("name");
+
+    EXPECT_FALSE(ptr->checkRules(tag.get()));
 }
 
 TEST(SelectAllWithAttribute, BadTag)
@@ -174,10 +218,14 @@ TEST(SelectAllWithEndString, ValidCase)
     EXPECT_TRUE(ptr->checkRules(tag.get()));
 }
 
-TEST(SelectAllWithEndString, BadRule)
+TEST(SelectAllWithEndString, WithoutDot)
 {
     std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("[size$='png']"));
-    EXPECT_EQ(ptr, nullptr);
+    std::unique_ptr<Tag> tag(new Tag);
+    tag->setAttributeTag("size");
+    tag->setAttributeValueTag("picture.png");
+
+    EXPECT_TRUE(ptr->checkRules(tag.get()));
 }
 
 TEST(SelectAllWithEndString, AnotherEndString)
@@ -556,10 +604,21 @@ TEST(SelectChildrenTagWithAttribute, ValidCase)
     EXPECT_TRUE(ptr->checkRules(tag.get()));
 }
 
-TEST(SelectChildrenTagWithAttribute, WrongRule)
+TEST(SelectChildrenTagWithAttribute, ThreeAttributes)
 {
-    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("div[id=\"wrap\"][class=\"part1\"][class=\"sdf\"]"));
-    EXPECT_EQ(ptr, nullptr);
+    // Not one of the original shapes, so all the attributes belong to the div
+    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("div[id=\"wrap\"][class=\"part1\"][size=\"2\"]"));
+    std::unique_ptr<Tag> tag(new Tag);
+    tag->setTagName("div");
+    tag->setAttributeTag("id");
+    tag->setAttributeValueTag("wrap");
+    tag->setAttributeTag("class");
+    tag->setAttributeValueTag("part1");
+
+    EXPECT_FALSE(ptr->checkRules(tag.get()));
+    tag->setAttributeTag("size");
+    tag->setAttributeValueTag("2");
+    EXPECT_TRUE(ptr->checkRules(tag.get()));
 }
 
 TEST(SelectChildrenTagWithAttribute, MixAttributeAndValue)
@@ -717,9 +776,25 @@ TEST(SelectChildrenOfTheSpecificTag, AnotherParentAndChild)
     EXPECT_FALSE(ptr->checkRules(tag.get()));
 }
 
+TEST(SelectChildrenOfTheSpecificTag, Descendant)
+{
+    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("div  p"));
+    std::unique_ptr<Tag> grandParentTag(new Tag);
+    grandParentTag->setTagName("div");
+    std::unique_ptr<Tag> parentTag(new Tag);
+    parentTag->setTagName("body");
+    parentTag->setParent(grandParentTag.get());
+    std::unique_ptr<Tag> tag(new Tag);
+    tag->setTagName("p");
+    tag->setParent(parentTag.get());
+
+    EXPECT_TRUE(ptr->checkRules(tag.get()));
+    EXPECT_FALSE(ptr->checkRules(parentTag.get()));
+}
+
 TEST(SelectChildrenOfTheSpecificTag, BadRule)
 {
-    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("div  body"));
+    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("div > > body"));
     EXPECT_EQ(ptr, nullptr);
 }
 
@@ -763,6 +838,355 @@ TEST(SelectChildrenOfTheSpecificTag, BadTagName)
     EXPECT_FALSE(ptr->checkRules(tag.get()));
 }
 
+TEST(SelectAllWithEndString, AnyCharacter)
+{
+    std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory("[src$='.png']"));
+    std::unique_ptr<Tag> tag(new Tag);
+    tag->setAttributeTag("src");
+    tag->setAttributeValueTag("picture_png");
+
+    EXPECT_TRUE(ptr->checkRules(tag.get()));
+}
+
+TEST(SelectorCache, SharedRule)
+{
+    SelectorCache cache;
+    auto first = cache.get("body > div");
+    auto second = cache.get("body > div");
+
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(cache.get("&"), nullptr);
+    EXPECT_EQ(cache.getSize(), 2);
+
+    cache.clear();
+    EXPECT_EQ(cache.getSize(), 0);
+    EXPECT_NE(cache.get("body > div"), first);
+}
+
+TEST(SelectorCache, Capacity)
+{
+    SelectorCache cache(2);
+    cache.get("[a]");
+    cache.get("[b]");
+    cache.get("[c]");
+
+    EXPECT_LE(cache.getSize(), 2);
+    EXPECT_NE(cache.get("[a]"), nullptr);
+}
+
+namespace
+{
+    // <ul id="list"><li class="a b">1</li><li>2</li><p></p><li lang="en-US">3</li></ul>
+    void buildList(Document& document)
+    {
+        const uint32_t list = document.append();
+        document.getNode(list).setTagName("ul");
+        document.getNode(list).setAttributeTag("id");
+        document.getNode(list).setAttributeValueTag("list");
+        const char* names[] = {"li", "li", "p", "li"};
+
+        for (const auto name : names)
+        {
+            const uint32_t index = document.append(list);
+            document.getNode(index).setTagName(name);
+            document.getNode(index).setContent(std::string(name) == "p" ? "" : "text");
+            document.close(index);
+        }
+        document.close(list);
+        document.getNode(1).setAttributeTag("class");
+        document.getNode(1).setAttributeValueTag("a b");
+        document.getNode(4).setAttributeTag("lang");
+        document.getNode(4).setAttributeValueTag("en-US");
+    }
+
+    std::vector<uint32_t> select(Document& document, const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        std::vector<uint32_t> result;
+
+        if (ptr != nullptr)
+        {
+            for (uint32_t i = 0; i < document.getSize(); ++i)
+            {
+                if (ptr->checkRules(&document.getNode(i)))
+                {
+                    result.push_back(i);
+                }
+            }
+        }
+        return result;
+    }
+}
+
+TEST(CssSelector, SimpleSelectors)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    using Result = std::vector<uint32_t>;
+
+    EXPECT_EQ(select(document, "#list"), Result({0}));
+    EXPECT_EQ(select(document, "li.b"), Result({1}));
+    EXPECT_EQ(select(document, ".a.b"), Result({1}));
+    EXPECT_EQ(select(document, "[class~=\"a\"]"), Result({1}));
+    EXPECT_EQ(select(document, "[lang|=en]"), Result({4}));
+    EXPECT_EQ(select(document, "[lang^=\"en\"]"), Result({4}));
+    EXPECT_EQ(select(document, "[class $= 'b']"), Result({1}));
+    EXPECT_EQ(select(document, "[class*=\" \"]"), Result({1}));
+    EXPECT_EQ(select(document, "[class^='']"), Result());
+    EXPECT_EQ(select(document, "\6C i:empty"), Result());
+    EXPECT_EQ(select(document, "p:empty"), Result({3}));
+}
+
+TEST(CssSelector, Combinators)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    using Result = std::vector<uint32_t>;
+
+    EXPECT_EQ(select(document, "ul li"), Result({1, 2, 4}));
+    EXPECT_EQ(select(document, "ul > *"), Result({1, 2, 3, 4}));
+    EXPECT_EQ(select(document, "li + li"), Result({2}));
+    EXPECT_EQ(select(document, "li.a ~ li"), Result({2, 4}));
+    EXPECT_EQ(select(document, "p ~ *"), Result({4}));
+    EXPECT_EQ(select(document, "#list>p+li"), Result({4}));
+    EXPECT_EQ(select(document, "p, #list"), Result({0, 3}));
+}
+
+TEST(CssSelector, PseudoClasses)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    using Result = std::vector<uint32_t>;
+
+    EXPECT_EQ(select(document, "li:first-child"), Result({1}));
+    EXPECT_EQ(select(document, ":last-child"), Result({0, 4}));
+    EXPECT_EQ(select(document, "ul > :nth-child(odd)"), Result({1, 3}));
+    EXPECT_EQ(select(document, "ul > :nth-child(2n + 2)"), Result({2, 4}));
+    EXPECT_EQ(select(document, "ul > :nth-child(-n+2)"), Result({1, 2}));
+    EXPECT_EQ(select(document, "ul > :nth-child( -n+ 2 )"), Result({1, 2}));
+    EXPECT_EQ(select(document, "ul > :nth-child(+2N -1)"), Result({1, 3}));
+    EXPECT_EQ(select(document, "li:nth-of-type(3)"), Result({4}));
+    EXPECT_EQ(select(document, "li:nth-last-of-type(1)"), Result({4}));
+    EXPECT_EQ(select(document, ":only-of-type"), Result({0, 3}));
+    EXPECT_EQ(select(document, ":root"), Result({0}));
+    EXPECT_EQ(select(document, "li:not(.a)"), Result({2, 4}));
+    EXPECT_EQ(select(document, "ul :not(li):not([lang])"), Result({3}));
+}
+
+TEST(CssSelector, AncestorFilter)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    const char* rules[] = {"ul li", "#list > li", "ul.a li", "div li", "#list li + li", "[id] > .a ~ *", "li"};
+
+    for (const auto rule : rules)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        AncestorFilter filter;
+        std::vector<uint32_t> result;
+
+        for (uint32_t i = 0; i < document.getSize(); ++i)
+        {
+            filter.moveTo(document.getNode(i));
+            if (ptr->checkRules(&document.getNode(i), filter))
+            {
+                result.push_back(i);
+            }
+            filter.push(document.getNode(i));
+        }
+        EXPECT_EQ(result, select(document, rule)) << rule;
+    }
+
+    AncestorFilter filter;
+    filter.push(document.getNode(0));
+    filter.moveTo(document.getNode(1));
+    EXPECT_TRUE(filter.mayContain(AncestorFilter::hashTag(AtomTable::getGlobal().intern("ul"))));
+    EXPECT_TRUE(filter.mayContain(AncestorFilter::hashId("list")));
+    EXPECT_FALSE(filter.mayContain(AncestorFilter::hashClass("list")));
+
+    filter.moveTo(document.getNode(0));
+    EXPECT_FALSE(filter.mayContain(AncestorFilter::hashId("list")));
+}
+
+TEST(CssSelector, Regions)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    using Result = std::vector<uint32_t>;
+
+    auto regionRoots = [&document](const std::string& rule)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        Result result;
+
+        for (uint32_t i = 0; ptr->hasRegions() && i < document.getSize(); ++i)
+        {
+            if (ptr->isRegionRoot(document.getNode(i)))
+            {
+                result.push_back(i);
+            }
+        }
+        return result;
+    };
+
+    EXPECT_EQ(regionRoots("ul > li"), Result({0}));
+    EXPECT_EQ(regionRoots("#list li + li"), Result({0}));
+    EXPECT_EQ(regionRoots("li.a"), Result({1}));
+    EXPECT_EQ(regionRoots("ul:not(.a) :last-child"), Result({0}));
+    EXPECT_EQ(regionRoots("p, [id] li"), Result({0, 3}));
+    EXPECT_EQ(regionRoots("ul > li"), regionRoots("ul li"));
+
+    // The leftmost compound is not an ancestor, or needs more than the start tag
+    EXPECT_EQ(regionRoots("li + li"), Result());
+    EXPECT_EQ(regionRoots("p, li ~ li"), Result());
+    EXPECT_EQ(regionRoots("li:first-child"), Result());
+    EXPECT_EQ(regionRoots(":root li"), Result());
+    EXPECT_EQ(regionRoots("p:empty"), Result());
+    EXPECT_EQ(regionRoots("li:not(:last-child) > b"), Result());
+}
+
+TEST(CssSelector, SelectNodes)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    const char* rules[] = {"*", "li", "[class]", "[lang='en-US']", "ul > li", "ul li", "li + li", "#list > :not(p)", "p, li.a"};
+
+    for (const auto rule : rules)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        const std::vector<uint32_t> expected = select(document, rule);
+        std::vector<uint32_t> result;
+
+        ptr->selectNodes(document, result, SIZE_MAX);
+        EXPECT_EQ(result, expected) << rule;
+
+        result.clear();
+        ptr->selectNodes(document, result, 1);
+        EXPECT_EQ(result, std::vector<uint32_t>(expected.begin(), expected.begin() + 1)) << rule;
+
+        result.clear();
+        ptr->selectNodes(document, std::vector<uint32_t>({1, 2, 3}), result, SIZE_MAX);
+        std::vector<uint32_t> candidates;
+        std::copy_if(expected.begin(), expected.end(), std::back_inserter(candidates), [](uint32_t i)
+        {
+            return i >= 1 && i <= 3;
+        });
+        EXPECT_EQ(result, candidates) << rule;
+    }
+}
+
+namespace
+{
+    constexpr char listId[] = "list";
+    constexpr char wordB[] = "b";
+    constexpr char english[] = "en-US";
+
+    template <typename Selector>
+    std::vector<uint32_t> selectStatic(Document& document)
+    {
+        std::vector<uint32_t> result;
+        dom::selectNodes<Selector>(document, result);
+        return result;
+    }
+}
+
+TEST(SelectorDsl, SameAsCssSelector)
+{
+    Arena arena;
+    Document document(arena);
+    buildList(document);
+    using Li = dom::tag<KnownName::Li>;
+    using Ul = dom::tag<KnownName::Ul>;
+    using P = dom::tag<KnownName::P>;
+
+    using ById = dom::select<dom::id<listId>>;
+    EXPECT_EQ(selectStatic<ById>(document), select(document, "#list"));
+    using ByClass = dom::select<Li, dom::hasClass<wordB>>;
+    EXPECT_EQ(selectStatic<ByClass>(document), select(document, "li.b"));
+    using WithAttribute = dom::select<dom::hasAttr<KnownName::Lang>>;
+    EXPECT_EQ(selectStatic<WithAttribute>(document), select(document, "[lang]"));
+    using WithValue = dom::select<dom::attr<KnownName::Lang, english>>;
+    EXPECT_EQ(selectStatic<WithValue>(document), select(document, "[lang='en-US']"));
+    using WithOtherValue = dom::select<dom::attr<KnownName::Lang, wordB>>;
+    EXPECT_EQ(selectStatic<WithOtherValue>(document), select(document, "[lang='b']"));
+    using Descendant = dom::select<Ul, dom::descendant, Li>;
+    EXPECT_EQ(selectStatic<Descendant>(document), select(document, "ul li"));
+    using Adjacent = dom::select<dom::id<listId>, dom::child, P, dom::adjacent, Li>;
+    EXPECT_EQ(selectStatic<Adjacent>(document), select(document, "#list > p + li"));
+    using Sibling = dom::select<dom::hasClass<wordB>, dom::sibling, Li>;
+    EXPECT_EQ(selectStatic<Sibling>(document), select(document, ".b ~ li"));
+    using AnyParent = dom::select<dom::child, P>;
+    EXPECT_EQ(selectStatic<AnyParent>(document), select(document, "* > p"));
+
+    dom::Rule<dom::select<Ul, dom::child, Li>> rule;
+    std::vector<uint32_t> result;
+    rule.selectNodes(document, result, 2);
+    EXPECT_EQ(result, std::vector<uint32_t>({1, 2}));
+    EXPECT_FALSE(rule.checkRules(&document.getNode(3)));
+}
+
+TEST(CssSelector, BadRule)
+{
+    const char* rules[] = {"", "div,", "div >", "::before", ":hover", "li:not(:not(p))", "[a=b", "p:nth-child(n+)", "#1", "ns|div",
+                           "li:nth-child(1 0)", "li:nth-child(2 n+1)", "li:nth-child(- n+3)", "li:nth-child(+ 2)",
+                           "li:nth-child(2n 1)"};
+
+    for (const auto rule : rules)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        EXPECT_EQ(ptr, nullptr) << rule;
+    }
+}
+
+TEST(RuleEvaluation, NoAllocations)
+{
+    const std::string page = "<html><body><div id=\"wrap\" class=\"part1 main\" size=\"2\">"
+                             "<p class=\"name\" size=\"2\">Text</p><ul class=\"part1\"><li lang=\"en-US\">1</li><li>2</li></ul>"
+                             "<img src=\"a.gif\" width=\"10\"></div><p></p></body></html>";
+    Arena arena;
+    Document document(arena);
+    TreeBuilder(document).build(page.data(), page.size());
+    const char* rules[] = {"*", "div", "[size]", "[size='2']", "[size!='some.gif']", "[class*='name']", "[src^='a.']",
+                           "[src$='.gif']", "body > div", "div[id=\"wrap\"][class=\"part1\"]", "p[size=\"2\"]",
+                           "[class=\"name\"],[size=\"2\"]", "div.main p", "#wrap > ul li:nth-child(2n+1)",
+                           "li[lang|=en] ~ *", "[class~=part1] + p:empty, ul :last-of-type"};
+
+    for (const auto rule : rules)
+    {
+        std::unique_ptr<CheckRulesFactory> ptr(CheckRulesFactory::createCheckRulesFactory(rule));
+        ASSERT_NE(ptr, nullptr) << rule;
+        // The filter keeps its capacity, the first pass sizes it for the depth of the document
+        AncestorFilter filter;
+        size_t matches = 0;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const size_t before = allocationCount;
+            filter.clear();
+
+            for (auto& i : document.getNodes())
+            {
+                filter.moveTo(i);
+                matches += ptr->checkRules(&i) ? 1 : 0;
+                matches += ptr->checkRules(&i, filter) ? 1 : 0;
+                filter.push(i);
+            }
+            if (pass == 1)
+            {
+                EXPECT_EQ(allocationCount, before) << rule;
+            }
+        }
+        EXPECT_GT(matches, 0u) << rule;
+    }
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
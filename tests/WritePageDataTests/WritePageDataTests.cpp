@@ -30,6 +30,33 @@ TEST(Test2, Exception)
     EXPECT_THROW(writePageData.writeToFile(), std::logic_error);
 }
 
+TEST(Test3, StandaloneTree)
+{
+    // Tags built outside of a page keep their children when pushed and written
+    Tag list("ul");
+    Tag first("li");
+    Tag second("li");
+    first.setContent("1");
+    second.setContent("2");
+    list.setChildren(&first);
+    list.setChildren(&second);
+    ASSERT_EQ(list.getChildren().size(), 2);
+    EXPECT_EQ(second.getParent(), &list);
+
+    std::shared_ptr<IDOMFactory> ptr(new PageDataFactory);
+    std::shared_ptr<IPageData> pageData(ptr->createPageData("index.html"));
+    pageData->pushFront(list);
+    ASSERT_EQ(pageData->children().size(), 2);
+    EXPECT_EQ(pageData->children()[1]->getContent(), "2");
+    EXPECT_EQ(pageData->querySelectorAll("ul > li").size(), 2);
+
+    WritePageData writePageData(pageData, "standalone.html");
+    writePageData.writeToFile();
+    std::shared_ptr<IPageData> pageData2(ptr->createPageData("standalone.html", "li"));
+    ASSERT_EQ(pageData2->getNumberOfTags(), 2);
+    EXPECT_EQ(pageData2->last()->getContent(), "2");
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);